@@ -8,6 +8,8 @@
 #include <vector>
 #include <deque>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <functional>
 #include <string>
 #include <random>
@@ -15,13 +17,46 @@
 #include <tuple>
 #include <fstream>
 #include <chrono>
+#include <new>
+#include <memory>
+#include <future>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+#include <csignal>
+#include <pthread.h>
+#include <sched.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #include "ilikeusur.cpp"
 
 #include "circularqueue.cpp"
+#include "sharedmemory.cpp"
 #include "logger.cpp"
+#include "topology.cpp"
+#include "perfcounter.cpp"
+#include "datafile.cpp"
+#include "verifier.cpp"
+#include "generator.cpp"
+#include "records.cpp"
+#include "workerpool.cpp"
 
 #include "job.cpp"
+#include "partition.cpp"
+#include "simdsort.cpp"
+#include "processgroup.cpp"
 
 #include "teststarter.cpp"
 
@@ -1,25 +1,60 @@
 /* check if ordered! */
+/* checkorder [output [input]] : output (std::cin if not given) in order, */
+/* and a permutation of input if given; *.bin files are mapped by mmap    */
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
+#include <fstream>
 #include <iterator>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdint>
 
-int main(){
-	std::ios_base::sync_with_stdio(false);
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "datafile.cpp"
+#include "verifier.cpp"
+
+/* the elements of a binary data file, mapped, or of a text one */
+struct elements{
+	std::vector<int> V;
+	mappedData<int> *M{nullptr};
 
-	std::string s;
-	std::getline(std::cin, s);
-	std::istringstream is(s);
-	std::vector<int> V{ std::istream_iterator<int>(is), std::istream_iterator<int>() };
-	for( int i=1; i<V.size(); ++i )
-		if( V[i]<V[i-1] ){
-			std::cout << "NOT ORDERED at " << i << ": " << V[i-1] << ' ' << V[i] << std::endl;
-			for( int j=std::max(i-10,0); j<std::min(i+10,static_cast<int>(V.size())-1); ++j )
-				std::cout << V[j] << ' ';
-			std::cout << std::endl;
+	explicit elements(const std::string& name){
+		if( isBinaryFile(name) )
+			M = new mappedData<int>(name);
+		else if( name.empty() )
+			V.assign(std::istream_iterator<int>(std::cin), std::istream_iterator<int>());
+		else {
+			std::ifstream file(name);
+			V.assign(std::istream_iterator<int>(file), std::istream_iterator<int>());
 		}
+	}
+	const int* data() const { return M ? M->data() : V.data(); }
+	std::size_t size() const { return M ? M->size() : V.size(); }
+	~elements(){ delete M; }
+};
+
+int main(int argc, char *argv[]){
+	std::ios_base::sync_with_stdio(false);
 
+	elements V(argc>1 ? argv[1] : "");
+	const std::size_t n{V.size()}, i{firstMisplaced(V.data(), n)};
+	if( i<n ){
+		std::cout << "NOT ORDERED at " << i << ": " << V.data()[i-1] << ' ' << V.data()[i] << std::endl;
+		for( std::size_t j=i>10 ? i-10 : 0; j<std::min(i+10, n); ++j )
+			std::cout << V.data()[j] << ' ';
+		std::cout << std::endl;
+	}
+	if( argc>2 ){
+		elements W(argv[2]);
+		if( hashMultiset(V.data(), n)!=hashMultiset(W.data(), W.size()) )
+			std::cout << "NOT A PERMUTATION of " << argv[2] << std::endl;
+	}
 
-	return 0;
-}
\ No newline at end of file
+	return i<n;
+}
@@ -82,6 +82,10 @@ public:
     bool full(){
         return static_cast<uint32_t>(d.load(std::memory_order_relaxed))==n;
     }
+
+    bool empty(){
+        return d.load(std::memory_order_relaxed)<=0;
+    }
 };
 #else
 /* Here I am relying for synchronization on weak CAS only ...   */
@@ -145,6 +149,10 @@ public:
     bool full(){
         return static_cast<uint32_t>(d.load(std::memory_order_relaxed))==n;
     }
+
+    bool empty(){
+        return d.load(std::memory_order_relaxed)<=0;
+    }
 };
 #endif
 #endif
@@ -0,0 +1,83 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Binary data files, named *.bin: a header, then the elements  */
+/* as a raw little endian array; read through mmap and written  */
+/* with a single write, so no parsing or formatting             */
+
+static_assert(__BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__, "binary data files are little endian");
+
+struct dataHeader{
+    char magic[4]{'D', 'E', 'I', 'S'};
+    uint32_t elementSize{0};
+    uint64_t count{0};
+};
+
+inline bool isBinaryFile(const std::string& name){
+    return name.size()>=4 && name.compare(name.size()-4, 4, ".bin")==0;
+}
+
+/* a binary data file mapped in memory, empty if it is not valid */
+template <class T>
+class mappedData{
+    void *map{MAP_FAILED};
+    std::size_t length{0};
+    const T *elements{nullptr};
+    std::size_t n{0};
+public:
+    explicit mappedData(const std::string& name){
+        const int fd{open(name.c_str(), O_RDONLY)};
+        if( fd<0 ){
+            std::cout << "Warning: cannot open " << name << "!" << std::endl;
+            return;
+        }
+        const off_t size{lseek(fd, 0, SEEK_END)};
+        if( size>=static_cast<off_t>(sizeof(dataHeader)) ){
+            length = size;
+            map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if( map==MAP_FAILED ){
+            std::cout << "Warning: " << name << " is not a binary data file!" << std::endl;
+            return;
+        }
+        /* count checked by a division: a product could wrap around */
+        const dataHeader *h(static_cast<const dataHeader*>(map));
+        if( std::memcmp(h->magic, dataHeader().magic, 4)!=0 || h->elementSize!=sizeof(T) || h->count>(length-sizeof(dataHeader))/sizeof(T) ){
+            std::cout << "Warning: " << name << " has not a valid header for elements of " << sizeof(T) << " bytes!" << std::endl;
+            return;
+        }
+        madvise(map, length, MADV_SEQUENTIAL);
+        elements = reinterpret_cast<const T*>(static_cast<const char*>(map)+sizeof(dataHeader));
+        n = h->count;
+    }
+
+    mappedData(const mappedData&) = delete;
+    mappedData& operator=(const mappedData&) = delete;
+
+    const T* data() const {
+        return elements;
+    }
+
+    std::size_t size() const {
+        return n;
+    }
+
+    ~mappedData(){
+        if( map!=MAP_FAILED )
+            munmap(map, length);
+    }
+};
+
+/* the header of n elements, to be followed by them */
+template <class T>
+void writeDataHeader(std::ostream& out, const std::size_t& n){
+    dataHeader h;
+    h.elementSize = sizeof(T);
+    h.count = n;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+}
+
+template <class T>
+void writeData(std::ostream& out, const T* V, const std::size_t& n){
+    writeDataHeader<T>(out, n);
+    out.write(reinterpret_cast<const char*>(V), n*sizeof(T));
+}
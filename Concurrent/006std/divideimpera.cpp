@@ -69,6 +69,14 @@ public:
         return myJobId;
     }
 
+    std::pair<const void*, const void*> getAffinity() override {
+        return dataRange(in);
+    }
+
+    uint64_t estimatedCost() override {
+        return jobCost(in);
+    }
+
     typeOut *pout{nullptr};
 
     ~recDivideJob() override {
@@ -77,23 +85,88 @@ public:
     }
 };
 
+/* LEAF BATCHING: sibling base cases in a single job, done in a tight */
+/* loop or by a batched base of the user; the impera job reads its k-th */
+/* output through getOutput(k)                                          */
+template <class typeOut, class typeIn>
+class leafBatchJob: public job{
+    std::vector<typeIn> in;
+    const uint64_t myJobId;
+    std::atomic<bool> complete;
+    std::vector<typeOut> out;
+    std::function<std::vector<typeOut>(const std::vector<typeIn>&)> f;
+public:
+    leafBatchJob(std::function<std::vector<typeOut>(const std::vector<typeIn>&)> ff, std::vector<typeIn>&& iin) 
+    : in(std::move(iin)), myJobId{ jobId.fetch_add(1, std::memory_order_relaxed) }, complete(false), out(), f(ff)
+    {}
+
+    void operator()() override {
+        out = f(std::cref(in));
+        complete.store(true, std::memory_order_release);
+    }
+
+    bool completed() override {
+        return complete.load(std::memory_order_acquire);
+    }
+
+    bool inputReady() override {
+        return true;
+    }
+
+    void* getOutput() override {
+        return &out;
+    }
+
+    void* getOutput(const int& k) override {
+        return &out[k];
+    }
+
+    uint64_t getJobId() override {
+        return myJobId;
+    }
+
+    std::pair<const void*, const void*> getAffinity() override {
+        auto r(dataRange(in.front()));
+        if( r.first!=nullptr )
+            r.second = dataRange(in.back()).second;
+        return r;
+    }
+
+    /* unknown if the cost of a leaf is, the sum saturated otherwise */
+    uint64_t estimatedCost() override {
+        uint64_t cost{0};
+        for( auto &i: in ){
+            const uint64_t c{jobCost(i)};
+            if( c==unknownCost )
+                return unknownCost;
+            cost = c>unknownCost-1-cost ? unknownCost-1 : cost+c;
+        }
+        return cost;
+    }
+};
+
 template <class typeOut>
 class imperaJob: public job{
     const uint64_t myJobId;
     typeOut*& poutput;
     std::atomic<bool> complete;
     std::vector<job *> IJ;                      /* Input Jobs   */
+    std::vector<int> K;                         /* k-th output of IJ, when a batch  */
     std::vector<typeOut> I;                     /* Input        */
     std::function<bool()> f;
 public:
     /* impera should write result in the out of the respective recDivide job... */
-    imperaJob(std::vector<job*>&& IIJ , std::function<bool(const std::vector<typeOut>&, typeOut*&)> ff, typeOut*& pout) 
-    : myJobId{jobId.fetch_add(1, std::memory_order_relaxed)}, poutput(pout), complete(false), IJ(IIJ), I(), f( std::bind(ff, std::cref(I),  std::ref(pout) ) )
+    imperaJob(std::vector<job*>&& IIJ , std::function<bool(const std::vector<typeOut>&, typeOut*&)> ff, typeOut*& pout, std::vector<int>&& KK = std::vector<int>()) 
+    : myJobId{jobId.fetch_add(1, std::memory_order_relaxed)}, poutput(pout), complete(false), IJ(IIJ), K(KK), I(), f( std::bind(ff, std::cref(I),  std::ref(pout) ) )
     {}
     /* WARNING: the check for ready input is external!  */
     void operator()() override {
-        for( auto &ij: IJ )
-            I.emplace_back(*static_cast<typeOut*>(ij->getOutput()));
+        if( K.empty() )
+            for( auto &ij: IJ )
+                I.emplace_back(*static_cast<typeOut*>(ij->getOutput()));
+        else
+            for( std::size_t c=0; c<IJ.size(); ++c )
+                I.emplace_back(*static_cast<typeOut*>(K[c]<0 ? IJ[c]->getOutput() : IJ[c]->getOutput(K[c])));
         complete.store(f(), std::memory_order_release);
     }
 
@@ -133,9 +206,41 @@ public:
         return myJobId;
     }
 
+    /* the data of the inputs, which are contiguous in all sane DAC    */
+    std::pair<const void*, const void*> getAffinity() override {
+        std::pair<const void*, const void*> r(nullptr, nullptr);
+        for( auto &ij: IJ ){
+            auto rr(ij->getAffinity());
+            if( rr.first==nullptr )
+                return std::pair<const void*, const void*>(nullptr, nullptr);
+            if( r.first==nullptr || rr.first<r.first )
+                r.first = rr.first;
+            if( r.second==nullptr || rr.second>r.second )
+                r.second = rr.second;
+        }
+        return r;
+    }
+
     ~imperaJob() {}
 };
 
+template <class typeIn, class typeOut>
+struct processNode{
+    enum : uint32_t { created, queued, running, local, divided, imperaRunning, done };
+    std::atomic<uint32_t> state;
+    uint32_t parent, first, k;
+    alignas(typeIn) unsigned char in[sizeof(typeIn)];
+    alignas(typeOut) unsigned char out[sizeof(typeOut)];
+
+    typeIn& input(){
+        return *reinterpret_cast<typeIn *>(in);
+    }
+
+    typeOut& output(){
+        return *reinterpret_cast<typeOut *>(out);
+    }
+};
+
 template <class typeIn, class typeOut>
 class divImp{
     std::function<std::vector<typeIn>(const typeIn&)> divide;
@@ -143,6 +248,18 @@ class divImp{
     std::function<typeOut(const typeIn&)> base;
     std::function<bool(const typeIn&)> isBase;
     std::chrono::duration<double> lastDuration;
+    std::string lastStatistics;
+    bool lazy{false}, locality{false}, batching{false};
+    std::function<std::vector<typeOut>(const std::vector<typeIn>&)> baseBatch;
+    uint64_t offerCost{0};
+    int shareWeight{0};
+    std::atomic<uint64_t> nJobs{0}, nLeaves{0}, nBatches{0};
+
+    typedef processNode<typeIn, typeOut> node;
+    node *N{nullptr};
+    std::atomic<uint32_t> *nN{nullptr};
+    const uint32_t processCapacity{1<<20};      /* nodes of the shared tree */
+    uint32_t rerunImperas{0};
 
     typeOut recDivide(const typeIn& in){
         if( isBase(std::cref(in)) )
@@ -157,6 +274,7 @@ class divImp{
 
     bool recDivideFun(std::vector<job *>& PJ, std::vector<job *>& DJ, workgroup& g, const typeIn& in, typeOut *&pout){
         if( isBase(std::cref(in)) ){
+            nLeaves.fetch_add(1, std::memory_order_relaxed);
             pout = new typeOut(base(std::cref(in)));
             return true;
         }
@@ -166,6 +284,11 @@ class divImp{
             return true;
         }
 
+        if( lazy ){
+            pout = new typeOut(lazyRecDivide(g, in));
+            return true;
+        }
+
         auto setDistributableJobs = [&]() -> std::vector<job*> {
             std::vector<job*> J;
             for( auto &i: divide(std::cref(in)) ){
@@ -176,11 +299,100 @@ class divImp{
             return J;
         };
 
+        if( batching )
+            return batchedDivide(PJ, DJ, g, in, pout);
+
         PJ.push_back(newImperaJob(setDistributableJobs(), pout));
 
         return true;
     } 
 
+    /* as above, but children which are base cases go in one leafBatchJob  */
+    bool batchedDivide(std::vector<job *>& PJ, std::vector<job *>& DJ, workgroup& g, const typeIn& in, typeOut *&pout){
+        auto I(divide(std::cref(in)));
+        std::vector<job*> J(I.size(), nullptr);
+        std::vector<int> K(I.size(), -1);
+        std::vector<typeIn> leaves;
+        for( std::size_t c=0; c<I.size(); ++c )
+            if( isBase(std::cref(I[c])) ){
+                K[c] = static_cast<int>(leaves.size());
+                leaves.push_back(I[c]);
+            }
+        if( leaves.size()<2 )
+            std::fill(K.begin(), K.end(), -1);
+        else {
+            job *b(newLeafBatchJob(std::move(leaves)));
+            DJ.push_back(b);
+            for( std::size_t c=0; c<I.size(); ++c )
+                if( K[c]>=0 )
+                    J[c] = b;
+        }
+        for( std::size_t c=0; c<I.size(); ++c )
+            if( J[c]==nullptr ){
+                J[c] = newRecDivideJob(g, I[c]);
+                DJ.push_back(J[c]);
+            }
+
+        std::function<bool(const std::vector<typeOut>&, typeOut*&)> ff 
+            = std::bind( &divImp::imperaFun, this, _1, _2 );
+        nJobs.fetch_add(1, std::memory_order_relaxed);
+        PJ.push_back(new imperaJob<typeOut>(std::move(J), ff, pout, std::move(K)));
+
+        return true;
+    }
+
+    std::vector<typeOut> leafBatchFun(const std::vector<typeIn>& I){
+        nLeaves.fetch_add(I.size(), std::memory_order_relaxed);
+        if( baseBatch )
+            return baseBatch(std::cref(I));
+        std::vector<typeOut> V;
+        V.reserve(I.size());
+        for( auto &i: I )
+            V.emplace_back(base(std::cref(i)));
+        return V;
+    }
+
+    /* LAZY SPLITTING: go on sequentially, and only when some worker is    */
+    /* idle package the last children as jobs and give them away; the      */
+    /* first child is always kept, then we wait for the others to complete */
+    typeOut lazyRecDivide(workgroup& g, const typeIn& in){
+        if( isBase(std::cref(in)) )
+            return base(std::cref(in));
+        if( in.depth < typeIn::threshold )
+            return recDivide(in);
+
+        auto I(divide(std::cref(in)));
+        std::vector<job *> J(I.size(), nullptr);
+        for( int c=static_cast<int>(I.size())-1; c>0 && g.idle(); --c ){
+            job *j(newRecDivideJob(g, I[c]));
+            if( !g.worthOffering(j) || !g.offerJob(j) ){
+                delete j;
+                --nJobs;
+                break;
+            }
+            J[c] = j;
+        }
+
+        std::deque<typeOut> local;
+        for( int c=0; c<static_cast<int>(I.size()); ++c )
+            if( J[c]==nullptr )
+                local.emplace_back(lazyRecDivide(g, I[c]));
+
+        std::vector<typeOut> V;
+        for( int c=0; c<static_cast<int>(I.size()); ++c ){
+            if( J[c]==nullptr ){
+                V.emplace_back(local.front());
+                local.pop_front();
+            } else {
+                while( !J[c]->completed() )
+                    std::this_thread::yield();
+                V.emplace_back(*static_cast<typeOut *>(J[c]->getOutput()));
+            }
+        }
+
+        return impera(std::cref(V));
+    }
+
     bool imperaFun(const std::vector<typeOut>& Vout, typeOut*& pout){
         pout = new typeOut(impera(std::cref(Vout)));
 
@@ -190,16 +402,222 @@ class divImp{
     job *newRecDivideJob(workgroup& g, const typeIn& in){
         std::function<bool(std::vector<job*>&, std::vector<job*>&, workgroup&, const typeIn&, typeOut*&)> ff 
             = std::bind( &divImp::recDivideFun, this, _1, _2, _3, _4, _5 );
+        nJobs.fetch_add(1, std::memory_order_relaxed);
         return new recDivideJob<typeOut, typeIn>(g, ff, in);
     }
 
+    job *newLeafBatchJob(std::vector<typeIn>&& I){
+        std::function<std::vector<typeOut>(const std::vector<typeIn>&)> ff 
+            = std::bind( &divImp::leafBatchFun, this, _1 );
+        nJobs.fetch_add(1, std::memory_order_relaxed);
+        nBatches.fetch_add(1, std::memory_order_relaxed);
+        return new leafBatchJob<typeOut, typeIn>(ff, std::move(I));
+    }
+
     job *newImperaJob(std::vector<job*>&& IJ, typeOut*& pout){
         std::function<bool(const std::vector<typeOut>&, typeOut*&)> ff 
             = std::bind( &divImp::imperaFun, this, _1, _2 );
+        nJobs.fetch_add(1, std::memory_order_relaxed);
         return new imperaJob<typeOut>(std::move(IJ), ff, pout);
     }
+    /* PROCESS MODE: the DAC tree is kept in shared memory, N[0] is the root; */
+    /* a node is executed by whoever wins the queued->running transition, and */
+    /* impera is executed by whoever sees all the children done, so that all  */
+    /* the steps can be retried after the death of a worker process: see      */
+    /* processRecover for which ones are retried exactly                      */
+    void processFinish(processgroup& g, const int& id, const uint32_t& n){
+        N[n].state.store(node::done, std::memory_order_release);
+        if( n==0 )
+            g.complete();
+        else
+            processCheck(g, id, N[n].parent);
+    }
+
+    void processCheck(processgroup& g, const int& id, const uint32_t& n){
+        if( N[n].state.load(std::memory_order_acquire)!=node::divided )
+            return;
+        for( uint32_t c=N[n].first; c<N[n].first+N[n].k; ++c )
+            if( N[c].state.load(std::memory_order_acquire)!=node::done )
+                return;
+        uint32_t s{node::divided};
+        if( !N[n].state.compare_exchange_strong(s, node::imperaRunning, std::memory_order_acquire) )
+            return;
+        g.working(id, n);
+        std::vector<typeOut> V;
+        for( uint32_t c=N[n].first; c<N[n].first+N[n].k; ++c )
+            V.emplace_back(N[c].output());
+        new (N[n].out) typeOut(impera(std::cref(V)));
+        processFinish(g, id, n);
+    }
+
+    void processDivide(processgroup& g, const int& id, const uint32_t& n){
+        uint32_t s{node::queued};
+        g.working(id, n);
+        if( !N[n].state.compare_exchange_strong(s, node::running, std::memory_order_acquire) )
+            return;
+
+        const typeIn& in(N[n].input());
+        if( isBase(std::cref(in)) ){
+            new (N[n].out) typeOut(base(std::cref(in)));
+            processFinish(g, id, n);
+            return;
+        }
+        if( in.depth < typeIn::threshold ){
+            N[n].state.store(node::local, std::memory_order_relaxed);
+            new (N[n].out) typeOut(recDivide(in));
+            processFinish(g, id, n);
+            return;
+        }
+
+        auto I(divide(std::cref(in)));
+        uint32_t k(I.size()), first{nN->fetch_add(k, std::memory_order_relaxed)};
+        if( k==0 || first+k>processCapacity ){      /* no more room in the tree: go on locally */
+            N[n].state.store(node::local, std::memory_order_relaxed);
+            std::vector<typeOut> V;
+            for( auto &i: I )
+                V.emplace_back(recDivide(i));
+            new (N[n].out) typeOut(impera(std::cref(V)));
+            processFinish(g, id, n);
+            return;
+        }
+        for( uint32_t c=0; c<k; ++c ){
+            new (N[first+c].in) typeIn(I[c]);
+            N[first+c].parent = n;
+            N[first+c].k = 0;
+            N[first+c].state.store(node::queued, std::memory_order_relaxed);
+        }
+        N[n].first = first;
+        N[n].k = k;
+        N[n].state.store(node::divided, std::memory_order_release);
+        for( uint32_t c=first; c<first+k; ++c )
+            if( !g.push(id, c, processgroup::divide) )
+                processDivide(g, id, c);
+    }
+
+    void processCycle(processgroup& g, int id){
+        processgroup::descriptor d;
+        while( !g.isCompleted() ){
+            if( g.pop(id, d) ){
+                if( d.phase==processgroup::divide )
+                    processDivide(g, id, d.node);
+                else
+                    processCheck(g, id, d.node);
+            } else
+                g.idle(id);
+        }
+    }
+
+    /* executed by the parent: give back to the queue what was lost. The   */
+    /* lost node is run again on its input as the dead process left it, so */
+    /* only divide and base are recovered exactly, as they do not write    */
+    /* their input in the mergesorts; an impera, or a subtree run locally, */
+    /* may have been merging in place (mergesort half, nmergesort) and is  */
+    /* run again with a warning, counted in the statistics: see verify     */
+    void processRecover(processgroup& g, int dead){
+        uint32_t n{g.workingOn(dead)};
+        if( n==processgroup::none )
+            return;
+        switch( N[n].state.load(std::memory_order_acquire) ){
+        case node::local:
+            std::cout << "Warning: node " << n << " was run locally by P" << dead << ", its input may have been overwritten!" << std::endl;
+            ++rerunImperas;
+            /* falls through */
+        case node::queued:
+        case node::running:
+            N[n].state.store(node::queued, std::memory_order_release);
+            g.push(0, n, processgroup::divide);
+            break;
+        case node::divided:
+            for( uint32_t c=N[n].first; c<N[n].first+N[n].k; ++c )
+                if( N[c].state.load(std::memory_order_acquire)==node::queued )
+                    g.push(0, c, processgroup::divide);
+            g.push(0, n, processgroup::check);
+            break;
+        case node::imperaRunning:
+            std::cout << "Warning: node " << n << " was merged by P" << dead << ", its inputs may have been overwritten!" << std::endl;
+            ++rerunImperas;
+            N[n].state.store(node::divided, std::memory_order_release);
+            g.push(0, n, processgroup::check);
+            break;
+        case node::done:
+            if( n==0 )
+                g.complete();
+            else
+                g.push(0, N[n].parent, processgroup::check);
+            break;
+        }
+    }
 public:
+    /* Workers are n processes instead of threads: typeIn and typeOut are   */
+    /* copied through shared memory, so they must be trivially copyable and */
+    /* refer only to memory shared before the fork (see dataVector)         */
+    typeOut startProcesses(const typeIn& in, int n, jobLogger* plogMe, bool wthChrono = false){
+        static_assert(std::is_trivially_copyable<typeIn>::value && std::is_trivially_copyable<typeOut>::value, 
+            "process mode needs trivially copyable input and output");
+        if( n<1 )
+            return start(in, n, plogMe, wthChrono);
+
+        processgroup pg(n, processCapacity, shmSegment::align(sizeof(std::atomic<uint32_t>))+std::size_t(processCapacity)*sizeof(node));
+        if( !pg.valid() ){
+            std::cout << "Warning: cannot map the shared segment, going on with threads!" << std::endl;
+            return start(in, n, plogMe, wthChrono);
+        }
+        rerunImperas = 0;
+        nN = new (pg.user<void>()) std::atomic<uint32_t>(1);
+        N = reinterpret_cast<node *>(reinterpret_cast<char *>(nN)+shmSegment::align(sizeof(std::atomic<uint32_t>)));
+        new (&N[0].state) std::atomic<uint32_t>(node::queued);
+        new (N[0].in) typeIn(in);
+        N[0].k = 0;
+        /* the other nodes are left untouched: fresh anonymous memory is    */
+        /* zero filled, that is state created, and pages are committed only */
+        /* when the tree reaches them                                        */
+        pg.push(0, 0, processgroup::divide);
+
+        pg.start(std::bind(&divImp::processCycle, this, std::ref(pg), _1), std::bind(&divImp::processRecover, this, std::ref(pg), _1), wthChrono);
+        if( wthChrono ){
+            lastDuration = pg.getDuration();
+            if( plogMe )
+                plogMe->push("==============  COMPLETED IN "+std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(lastDuration).count())+"ms  ==============");
+        }
+        for( auto &s: pg.printData() )
+            std::cout << s << '\n';
+        std::cout << std::flush;
+        lastStatistics = pg.getStatistics();
+        if( rerunImperas>0 )
+            lastStatistics += " rerunImperas="+std::to_string(rerunImperas);
+
+        typeOut out(N[0].output());
+        N = nullptr;
+        nN = nullptr;
+        return out;
+    }
+
+    void setLazy(bool lazySplitting){
+        lazy = lazySplitting;
+    }
+
+    void setLocality(bool nearToData){
+        locality = nearToData;
+    }
+
+    /* jobs estimated cheaper than cost are not handed off, 0: all are  */
+    void setOfferCost(uint64_t cost){
+        offerCost = cost;
+    }
+
+    /* sibling base cases in one job; batch, if given, does all of them  */
+    void setLeafBatching(bool leafBatching, std::function<std::vector<typeOut>(const std::vector<typeIn>&)> batch = nullptr){
+        batching = leafBatching;
+        baseBatch = batch;
+    }
+
+    /* weight among the tenants of the workerPool, 0: not in the pool    */
+    void setShare(int weight){
+        shareWeight = weight;
+    }
+
     typeOut start(const typeIn& in, int n, jobLogger* plogMe, bool wthChrono = false){
+        lastStatistics.clear();
         if(n<1){
             if( !wthChrono )
                 return recDivide(in);
@@ -215,7 +633,12 @@ public:
         }
 
         
-        workgroup wg(n);
+        workgroup wg(n, locality);
+        wg.setOfferCost(offerCost);
+        wg.setShare(shareWeight);
+        nJobs.store(0, std::memory_order_relaxed);
+        nLeaves.store(0, std::memory_order_relaxed);
+        nBatches.store(0, std::memory_order_relaxed);
         job *startingJob(newRecDivideJob(wg, in));
         if( plogMe )
             wg.start(startingJob, *plogMe, wthChrono);
@@ -226,6 +649,8 @@ public:
         for( auto &s: wg.printData() )
             std::cout << s << '\n';
         std::cout << std::flush;
+        lastStatistics = "jobs="+std::to_string(nJobs.load(std::memory_order_relaxed))+" leaves="+std::to_string(nLeaves.load(std::memory_order_relaxed))
+            +(batching ? " batches="+std::to_string(nBatches.load(std::memory_order_relaxed)) : "")+' '+wg.getStatistics();
 
         return *reinterpret_cast<typeOut*>(startingJob->getOutput());
     }
@@ -237,4 +662,8 @@ public:
     std::chrono::duration<double> getDuration(){
         return lastDuration;
     }
+
+    std::string getStatistics(){
+        return lastStatistics;
+    }
 };
\ No newline at end of file
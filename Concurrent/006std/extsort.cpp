@@ -0,0 +1,241 @@
+/* License : Michele Miccinesi 2018 -       */
+/* External mergesort components            */
+
+/* The input is read in chunks of chunkSize elements, the next one while */
+/* the last one is sorted by the parallel mergesort and spilled as a     */
+/* sorted run in a temporary file. Then the output is divided in parts   */
+/* by splitters sampled from the runs, and the parts are merged in       */
+/* parallel, each by a loser tree over its slices of the runs, read      */
+/* ahead a block at a time, and written behind a block at a time at its  */
+/* offset of the output file, so that I/O overlaps with the merge        */
+
+/* 0: an eighth of the physical memory, as 3 chunks are in memory     */
+std::size_t chunkSize{0};
+std::size_t blockSize{1<<16};           /* elements of a read or write   */
+std::string spillDir;                   /* "": TMPDIR, or /tmp              */
+
+inline std::size_t getChunkSize(const std::size_t& element){
+    if( chunkSize>0 )
+        return chunkSize;
+    const long pages{sysconf(_SC_PHYS_PAGES)}, page{sysconf(_SC_PAGESIZE)};
+    return pages>0 && page>0 ? std::max<std::size_t>(1<<16, std::size_t(pages)*page/8/element) : std::size_t(1)<<24;
+}
+
+/* an unlinked temporary file, removed when closed */
+inline int tempFile(){
+    std::string dir(spillDir);
+    if( dir.empty() )
+        dir = getenv("TMPDIR")!=nullptr ? getenv("TMPDIR") : "/tmp";
+    std::vector<char> name(dir.begin(), dir.end());
+    for( char c: std::string("/extsortXXXXXX") )
+        name.push_back(c);
+    name.push_back('\0');
+    const int fd{mkstemp(name.data())};
+    if( fd<0 )
+        throw std::runtime_error("extsort: cannot create a temporary file in "+dir);
+    unlink(name.data());
+    return fd;
+}
+
+/* whole pread/pwrite of n elements at element offset o */
+template <class T>
+void readAt(const int& fd, T* p, const std::size_t& n, const std::size_t& o){
+    char *c(reinterpret_cast<char*>(p));
+    for( std::size_t done{0}, all{n*sizeof(T)}; done<all; ){
+        const ssize_t r{pread(fd, c+done, all-done, o*sizeof(T)+done)};
+        if( r<=0 )
+            throw std::runtime_error("extsort: short read of a run");
+        done += r;
+    }
+}
+
+template <class T>
+void writeAt(const int& fd, const T* p, const std::size_t& n, const std::size_t& o){
+    const char *c(reinterpret_cast<const char*>(p));
+    for( std::size_t done{0}, all{n*sizeof(T)}; done<all; ){
+        const ssize_t w{pwrite(fd, c+done, all-done, o*sizeof(T)+done)};
+        if( w<=0 )
+            throw std::runtime_error("extsort: short write, out of disk space?");
+        done += w;
+    }
+}
+
+/* the elements [b,e) of a file as a source of the loser tree: the next */
+/* block is read asynchronously while the current one is consumed; the */
+/* reading starts at the first next, so that it can be moved before    */
+template <class T>
+class runReader{
+    int fd{-1};
+    std::size_t b{0}, e{0};
+    std::vector<T> cur, ahead;
+    std::size_t c{0};
+    std::future<void> reading;
+
+    void readAhead(){
+        const std::size_t n{std::min(blockSize, e-b)};
+        ahead.resize(n);
+        if( n>0 )
+            reading = std::async(std::launch::async, [this, n, o=b](){ readAt(fd, ahead.data(), n, o); });
+        b += n;
+    }
+public:
+    runReader() {}
+    runReader(const int& fd, const std::size_t& b, const std::size_t& e) : fd(fd), b(b), e(e) {}
+    runReader(runReader&&) = default;
+    runReader& operator=(runReader&&) = default;
+
+    bool next(T& x){
+        if( c==cur.size() ){
+            if( cur.empty() && ahead.empty() )
+                readAhead();
+            if( reading.valid() )
+                reading.get();
+            std::swap(cur, ahead);
+            c = 0;
+            if( cur.empty() )
+                return false;
+            readAhead();
+        }
+        x = cur[c++];
+        return true;
+    }
+
+    ~runReader(){
+        if( reading.valid() )
+            reading.wait();
+    }
+};
+
+/* output from element offset o: a full block is written asynchronously */
+/* while the next one is filled                                         */
+template <class T>
+class blockWriter{
+    int fd;
+    std::size_t o;
+    std::vector<T> cur, behind;
+    std::future<void> writing;
+public:
+    blockWriter(const int& fd, const std::size_t& o) : fd(fd), o(o) {
+        cur.reserve(blockSize);
+    }
+
+    T* block(){
+        cur.resize(blockSize);
+        return cur.data();
+    }
+
+    /* the first n of block() are done */
+    void flush(const std::size_t& n){
+        cur.resize(n);
+        if( writing.valid() )
+            writing.get();
+        std::swap(cur, behind);
+        if( !behind.empty() )
+            writing = std::async(std::launch::async, [this, o=o](){ writeAt(fd, behind.data(), behind.size(), o); });
+        o += n;
+    }
+
+    ~blockWriter(){
+        if( writing.valid() )
+            writing.wait();
+    }
+};
+
+/* first element of the run [b,e) of fd not less than x */
+template <class T>
+std::size_t lowerBound(const int& fd, std::size_t b, std::size_t e, const T& x){
+    while( b<e ){
+        const std::size_t m{b+(e-b)/2};
+        T y;
+        readAt(fd, &y, 1, m);
+        if( y<x )
+            b = m+1;
+        else
+            e = m;
+    }
+    return b;
+}
+
+/* runs [R[r],R[r+1]) of fd merged in out in nParts parts by a thread   */
+/* each; S is a sorted sample of the runs, from which the splitters are */
+template <class T>
+void mergeParts(const int& fd, const std::vector<std::size_t>& R, const std::vector<T>& S, const int& nParts, const int& out){
+    const int nR{static_cast<int>(R.size())-1};
+    /* C[q*(nR+1)+r]: where part q starts in run r, nR being the output  */
+    std::vector<std::size_t> C((nParts+1)*(nR+1));
+    for( int r=0; r<nR; ++r ){
+        C[r] = R[r];
+        C[nParts*(nR+1)+r] = R[r+1];
+    }
+    for( int q=1; q<nParts; ++q )
+        for( int r=0; r<nR; ++r )
+            C[q*(nR+1)+r] = lowerBound(fd, R[r], R[r+1], S[S.size()*q/nParts]);
+    for( int q=0; q<=nParts; ++q ){
+        C[q*(nR+1)+nR] = 0;
+        for( int r=0; r<nR; ++r )
+            C[q*(nR+1)+nR] += C[q*(nR+1)+r]-R[r];
+    }
+
+    auto part = [&](int q){
+        std::vector<runReader<T>> runs;
+        for( int r=0; r<nR; ++r )
+            runs.emplace_back(fd, C[q*(nR+1)+r], C[(q+1)*(nR+1)+r]);
+        kMergeSort::loserTree<T, runReader<T>> tree(std::move(runs));
+        blockWriter<T> writer(out, C[q*(nR+1)+nR]);
+        while( !tree.empty() ){
+            T *block(writer.block());
+            writer.flush(tree.merge(block, blockSize)-block);
+        }
+    };
+    std::vector<std::thread> parts;
+    for( int q=1; q<nParts; ++q )
+        parts.emplace_back(part, q);
+    part(0);
+    for( auto &t: parts )
+        t.join();
+}
+
+/* up to m elements of in, false if none */
+template <class T>
+bool readChunk(std::istream& in, std::vector<T>& C, const std::size_t& m){
+    C.clear();
+    for( T v; C.size()<m && in >> v; C.push_back(v) );
+    return !C.empty();
+}
+
+/* the input sorted in the returned temporary file, n its elements:    */
+/* read(C, m) gives the next chunk of up to m elements, false if none; */
+/* sort(C) sorts it and gives where the result is, until the next call; */
+/* statistics of the run in the returned string                         */
+template <class T, class Read, class F>
+std::string sortFile(Read read, F sort, const int& nParts, int& out, std::size_t& n){
+    const auto begin(std::chrono::steady_clock::now());
+    const std::size_t m{getChunkSize(sizeof(T))};
+    const int fd{tempFile()};
+    std::vector<std::size_t> R(1, 0);
+    std::vector<T> S, C, next;
+    read(C, m);
+    while( !C.empty() ){
+        auto reading(std::async(std::launch::async, [&](){ read(next, m); }));
+        const T *sorted(sort(C));
+        writeAt(fd, sorted, C.size(), R.back());
+        const std::size_t k{std::min<std::size_t>(C.size(), 64*nParts)};
+        for( std::size_t s=0; s<k; ++s )
+            S.push_back(sorted[C.size()*s/k]);
+        R.push_back(R.back()+C.size());
+        reading.get();
+        std::swap(C, next);
+    }
+    n = R.back();
+    std::sort(S.begin(), S.end());
+    const auto sorted(std::chrono::steady_clock::now());
+
+    out = tempFile();
+    if( n>0 )
+        mergeParts(fd, R, S, std::max(1, nParts), out);
+    close(fd);
+    const auto merged(std::chrono::steady_clock::now());
+    return "runs="+std::to_string(R.size()-1)+" parts="+std::to_string(std::max(1, nParts))
+        +" sortMs="+std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(sorted-begin).count())
+        +" mergeMs="+std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(merged-sorted).count());
+}
@@ -0,0 +1,170 @@
+/* License : Michele Miccinesi 2018 -                               */
+/* Synthetic inputs generated in memory, named distribution:size or */
+/* distribution:parameter:size, e.g. zipf:1e8 or almost:5:1e6. Each */
+/* element is a function of the seed and of its index, so chunks    */
+/* are generated in parallel and a name and a seed give the same    */
+/* input whatever the cores; nothing goes through a file            */
+
+enum class inputDistribution { uniform, sorted, reverse, few, zipf, organ, gauss, almost };
+
+struct inputSpec{
+    inputDistribution d{inputDistribution::uniform};
+    double parameter{0};
+    std::size_t n{0};
+    bool valid{false};
+};
+
+inline bool isGeneratedInput(const std::string& name){
+    return name.find(':')!=std::string::npos;
+}
+
+/* default parameters: distinct values of few, exponent of zipf,    */
+/* deviation of gauss as a fraction of the range, % of swaps of     */
+/* almost; a .bin suffix (input.bin=) is dropped                    */
+inline inputSpec parseInputSpec(const std::string& input){
+    static const std::vector<std::tuple<std::string, inputDistribution, double>> known{
+        std::make_tuple("uniform", inputDistribution::uniform, 0.), std::make_tuple("sorted", inputDistribution::sorted, 0.),
+        std::make_tuple("reverse", inputDistribution::reverse, 0.), std::make_tuple("few", inputDistribution::few, 16.),
+        std::make_tuple("zipf", inputDistribution::zipf, 1.), std::make_tuple("organ", inputDistribution::organ, 0.),
+        std::make_tuple("gauss", inputDistribution::gauss, 0.125), std::make_tuple("almost", inputDistribution::almost, 1.)
+    };
+    inputSpec spec;
+    const std::string name(isBinaryFile(input) ? input.substr(0, input.size()-4) : input);
+    const std::size_t a{name.find(':')}, b{name.rfind(':')};
+    for( auto &k: known )
+        if( name.compare(0, a, std::get<0>(k))==0 && std::get<0>(k).size()==a ){
+            spec.d = std::get<1>(k);
+            spec.parameter = std::get<2>(k);
+            spec.valid = true;
+        }
+    try{
+        if( b>a )
+            spec.parameter = std::stod(name.substr(a+1, b-a-1));
+        spec.n = static_cast<std::size_t>(std::stod(name.substr(b+1)));
+    } catch( const std::exception& ){
+        spec.valid = false;
+    }
+    if( (spec.d==inputDistribution::few && spec.parameter<1) || (spec.d==inputDistribution::zipf && spec.parameter<=0) || spec.parameter<0 )
+        spec.valid = false;
+    return spec;
+}
+
+/* splitmix64 from a state given by the seed and the index */
+struct counterRandom{
+    uint64_t state;
+    counterRandom(const uint64_t& seed, const std::size_t& x) : state(mix64(seed)^mix64(x+0x632be59bd9b4e019ull)) {}
+    uint64_t operator()(){
+        return mix64(state += 0x9e3779b97f4a7c15ull);
+    }
+    /* in (0,1) */
+    double unit(){
+        return ((*this)()>>11)*(1./9007199254740992.)+(0.5/9007199254740992.);
+    }
+};
+
+/* r/m of the range of T: in order and spread over the high bytes */
+template <class T>
+inline T spread(const uint64_t& r, const uint64_t& m){
+    if( std::is_floating_point<T>::value )
+        return static_cast<T>(r);
+    const uint64_t low(static_cast<uint64_t>(std::numeric_limits<T>::lowest())), range(static_cast<uint64_t>(std::numeric_limits<T>::max())-low);
+    return static_cast<T>(low+r*std::max<uint64_t>(1, range/std::max<uint64_t>(1, m)));
+}
+
+/* any value of T for integers, in (-1,1) for floats */
+template <class T>
+inline T anyValue(counterRandom& r){
+    if( std::is_floating_point<T>::value )
+        return static_cast<T>(2*r.unit()-1);
+    return static_cast<T>(r());
+}
+
+/* Zipf ranks in [1,m] with exponent s by rejection-inversion       */
+/* (Hoermann and Derflinger), a few draws per rank whatever m       */
+class zipfRanks{
+    double s, hX1, hM, t;
+    static double helper1(const double& x){
+        return std::abs(x)>1e-8 ? std::log1p(x)/x : 1-x*(0.5-x*(1./3-0.25*x));
+    }
+    static double helper2(const double& x){
+        return std::abs(x)>1e-8 ? std::expm1(x)/x : 1+x*0.5*(1+x*(1./3)*(1+0.25*x));
+    }
+    double h(const double& x) const {
+        return std::exp(-s*std::log(x));
+    }
+    double hIntegral(const double& x) const {
+        const double l{std::log(x)};
+        return helper2((1-s)*l)*l;
+    }
+    double hIntegralInverse(const double& x) const {
+        return std::exp(helper1(std::max(-1., x*(1-s)))*x);
+    }
+public:
+    const uint64_t m;
+    zipfRanks(const uint64_t& m, const double& s) : s(s), hX1(hIntegral(1.5)-1), hM(hIntegral(m+0.5)), t(2-hIntegralInverse(hIntegral(2.5)-h(2))), m(m) {}
+    uint64_t operator()(counterRandom& r) const {
+        for( ; ; ){
+            const double u{hM+r.unit()*(hX1-hM)}, x{hIntegralInverse(u)};
+            const uint64_t k{static_cast<uint64_t>(std::min<double>(m, std::max(1., x+0.5)))};
+            if( k-x<=t || u>=hIntegral(k+0.5)-h(k) )
+                return k;
+        }
+    }
+};
+
+/* V of the input named spec, false if the name is not valid */
+template <class T>
+bool generateInput(const std::string& name, const uint64_t& seed, std::vector<T>& V){
+    const inputSpec spec(parseInputSpec(name));
+    if( !spec.valid ){
+        std::cout << "Warning: " << name << " is not a valid distribution:[parameter:]size!" << std::endl;
+        return false;
+    }
+    const std::size_t n{spec.n};
+    const double p{spec.parameter};
+    const zipfRanks zipf(std::max<std::size_t>(1, n), spec.d==inputDistribution::zipf ? p : 1.);
+    const uint64_t distinct{static_cast<uint64_t>(p)};
+    V.resize(n);
+    forChunks(n, coreChunks(n), [&](int, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<e; ++x ){
+            counterRandom r(seed, x);
+            switch( spec.d ){
+            case inputDistribution::uniform:
+                V[x] = anyValue<T>(r);
+                break;
+            case inputDistribution::sorted:
+            case inputDistribution::almost:
+                V[x] = spread<T>(x, n);
+                break;
+            case inputDistribution::reverse:
+                V[x] = spread<T>(n-1-x, n);
+                break;
+            case inputDistribution::few:
+                V[x] = spread<T>(r()%distinct, distinct);
+                break;
+            case inputDistribution::zipf:
+                V[x] = spread<T>(zipf(r)-1, n);
+                break;
+            case inputDistribution::organ:
+                V[x] = spread<T>(2*std::min(x, n-1-x), n);
+                break;
+            case inputDistribution::gauss:
+            {
+                /* Box-Muller, clamped to the range */
+                const double z{std::sqrt(-2*std::log(r.unit()))*std::cos(6.283185307179586*r.unit())}, g{std::min(1., std::max(0., 0.5+p*z))};
+                V[x] = spread<T>(static_cast<uint64_t>(g*(n-1)), n);
+                break;
+            }
+            }
+        }
+    });
+    /* p% of n swaps of random pairs, in sequence to be reproducible */
+    if( spec.d==inputDistribution::almost && n>1 ){
+        counterRandom r(seed, n);
+        for( std::size_t s=static_cast<std::size_t>(n*p/100); s>0; --s ){
+            const std::size_t x(r()%n), y(r()%n);
+            std::swap(V[x], V[y]);
+        }
+    }
+    return true;
+}
@@ -14,6 +14,9 @@
 
 std::atomic<uint64_t> jobId{0};
 
+/* cost of a job whose size is not known: it is always worth offering   */
+constexpr uint64_t unknownCost{ ~uint64_t(0) };
+
 class job{
 public:
     virtual void operator()() {}
@@ -30,11 +33,38 @@ public:
 
     virtual void* getOutput() { return nullptr; } 
 
+    virtual void* getOutput(const int&) { return getOutput(); }    /* k-th of a batch */
+
     virtual uint64_t getJobId() { return 0; }
 
+    virtual std::pair<const void*, const void*> getAffinity() { return std::pair<const void*, const void*>(nullptr, nullptr); }
+
+    virtual uint64_t estimatedCost() { return unknownCost; }   /* ~ elements touched  */
+
     virtual ~job() {}
 };
 
+/* Memory touched by a job, used as a hint for its placement:  */
+/* overload dataRange for your typeIn, ADL will find it        */
+typedef std::pair<const void*, const void*> memoryRange;
+
+template <class T>
+memoryRange dataRange(const T&){
+    return memoryRange(nullptr, nullptr);
+}
+
+/* Size of a job, to decide whether it is worth a hand-off to another  */
+/* worker: overload jobCost for your typeIn, ADL will find it          */
+template <class T>
+uint64_t jobCost(const T&){
+    return unknownCost;
+}
+
+/* cost of sorting n elements    */
+inline uint64_t sortCost(const int64_t& n){
+    return n>1 ? uint64_t(n)*(64-__builtin_clzll(uint64_t(n))) : 1;
+}
+
 template <typename group>
 class genericWorker{
     const int id;
@@ -72,7 +102,8 @@ class genericWorker{
         return gotIt;
     }
 
-    void doJ(){
+    void doJ(group& g){
+        g.touch(id, j);
         (*j)();
         job* jj;
         while( j->getPendingJob(jj) )
@@ -84,7 +115,8 @@ class genericWorker{
         j=nullptr;
     }
 
-    void doJ(jobLogger& logMe){
+    void doJ(group& g, jobLogger& logMe){
+        g.touch(id, j);
         (*j)();
         if( logMe.logging( jobLogger::jobCompleted ) )
             logMe.push(idS+" completed J"+std::to_string(j->getJobId()));
@@ -111,10 +143,10 @@ class genericWorker{
             j=DJ.front();
             DJ.pop_front();
             #endif
-            doJ();
+            doJ(g);
         } else 
         #endif
-        if( g.offerJob(DJ.front()) ) {
+        if( g.worthOffering(DJ.front()) && g.offerJob(DJ.front()) ) {
             DJ.pop_front();
         } else {
             #ifdef DFS_TO_ME_BFS_TO_YOU
@@ -124,7 +156,7 @@ class genericWorker{
             j=DJ.front();
             DJ.pop_front();
             #endif
-            doJ();
+            doJ(g);
         }
         return true;
     }
@@ -146,10 +178,10 @@ class genericWorker{
             DJ.pop_front();
             #endif
             logMe.push(idS+"=====> doing DJ"+std::to_string(j->getJobId()));
-            doJ(logMe);
+            doJ(g, logMe);
         } else 
         #endif
-        if( g.offerJob(DJ.front()) ) {
+        if( g.worthOffering(DJ.front()) && g.offerJob(DJ.front()) ) {
             logMe.push(idS+"=====> offered DJ"+std::to_string(DJ.front()->getJobId()));
             DJ.pop_front();
         } else {
@@ -161,7 +193,7 @@ class genericWorker{
             DJ.pop_front();
             #endif
             logMe.push(idS+"=====> doing DJ"+std::to_string(j->getJobId()));
-            doJ(logMe);
+            doJ(g, logMe);
         }
         return true;
     }
@@ -171,10 +203,11 @@ class genericWorker{
         #ifndef ALL_BUT_1_DISTRIBUTE_WJ
         bool volatile gotWaitingJob{false};
         #endif
+        g.enter(id);
         while( !g.isCompleted() ){
             do {
                 if( g.lookForJob(id, j) ){
-                    doJ();
+                    doJ(g);
                     doneNewJob = true;
                 }
                 #ifdef ALL_BUT_1_DISTRIBUTE_WJ
@@ -182,7 +215,7 @@ class genericWorker{
                 #else
                 while( processDistributableJob(g) || (gotWaitingJob=getWaitingJob()) ){
                     if( gotWaitingJob ){
-                        doJ();
+                        doJ(g);
                         gotWaitingJob = false;
                     }
                 }
@@ -191,8 +224,11 @@ class genericWorker{
                     doneNewJob = false;
                     g.beAvailable(id);
                 }
+                if( DJ.empty() && g.overShare(id) && trim()==0 )
+                    g.park(id);
             } while( !g.closed() );
         }
+        g.leave(id);
     }
 
     void startLCycle(group& g, jobLogger& logMe){
@@ -200,12 +236,13 @@ class genericWorker{
         #ifndef ALL_BUT_1_DISTRIBUTE_WJ
         bool volatile gotWaitingJob{false};
         #endif
+        g.enter(id);
         while( !g.isCompleted() ){
             do {
                 if( g.lookForJob(id, j) ){
                     if( logMe.logging( jobLogger::jobReceiving ) )
                         logMe.push(idS+"=====> receiving J"+std::to_string(j->getJobId()));
-                    doJ(logMe);
+                    doJ(g, logMe);
                     doneNewJob = true;
                 }
                 #ifdef ALL_BUT_1_DISTRIBUTE_WJ
@@ -215,7 +252,7 @@ class genericWorker{
                     if( gotWaitingJob ){
                         if( logMe.logging( jobLogger::jobDoing ) )
                             logMe.push(idS+"=====> doing WJ"+std::to_string(j->getJobId()));
-                        doJ(logMe);
+                        doJ(g, logMe);
                         gotWaitingJob = false;
                     }
                 }
@@ -228,10 +265,16 @@ class genericWorker{
                 }
                 if( logMe.logging( jobLogger::jobSummary ) )
                     logMe.push(printData( logMe.logging( jobLogger::jobDependency ) )); 
+                if( DJ.empty() && g.overShare(id) && trim()==0 ){
+                    if( logMe.logging( jobLogger::workerAvailable ) )
+                        logMe.push(idS+"=====> is parked");
+                    g.park(id);
+                }
             } while( !g.closed() );
             if( logMe.logging( jobLogger::queueFull ) )
                 logMe.push(idS+"=====> sees queue FULL");
         }
+        g.leave(id);
     }
 public:
     explicit genericWorker(int id): id(id), idS("W"+std::to_string(id)), busy(ATOMIC_FLAG_INIT), j(nullptr), WJ(), DJ(), CJ() {}
@@ -358,6 +401,19 @@ public:
 /* ACHTUNG: I am NOT considering the possible sharing of the same job   */
 /* or of the same worker across different workgroups here! Be aware!!   */
 /* Could be interesting to implement it... not here, not now.           */
+/* Cores instead can be shared: workgroups with setShare are tenants of */
+/* the workerPool, which keeps running at most one worker per core      */
+
+class workgroup;
+
+/* the workgroup of the calling worker, if any: a job can ask the idle  */
+/* workers of its own workgroup for help, see parallelFor               */
+thread_local workgroup *currentWorkgroup{nullptr};
+
+/* the work of a thread marked uncounted is left out of the counters of */
+/* the report (merged bytes, runs found...): the other tenants. The     */
+/* workers of a workgroup take the mark of the thread creating it       */
+thread_local bool uncounted{false};
 
 #ifdef CIRCULAR_QUEUE
 
@@ -376,8 +432,12 @@ private:
     std::vector<std::atomic_flag> AA;           /* Already Available                */
     job *startingJob;
     std::chrono::duration<double> lastDuration;
+    uint64_t minOfferCost{0};                   /* cheaper jobs are kept local      */
+    const bool uncountedGroup{uncounted};
 public:
-    explicit workgroup(int n) : done{false}, n(n), ready(false), working(ATOMIC_FLAG_INIT), T(n), J(n), W(), A(n, -1), AA(n) {
+    /* NOTE: locality is not considered with the circular queue of available    */
+    /* workers, since we cannot choose whom we are popping                      */
+    explicit workgroup(int n, bool = false) : done{false}, n(n), ready(false), working(ATOMIC_FLAG_INIT), T(n), J(n), W(), A(n, -1), AA(n) {
         for( int i=0; i<n; ++i ){
             W.emplace_back(i);
             J[i].store(nullptr);
@@ -492,10 +552,50 @@ public:
             return false;
     }
 
+    void touch(const int&, job* const){
+    }
+
+    void setOfferCost(const uint64_t& cost){
+        minOfferCost = cost;
+    }
+
+    bool worthOffering(job* const j){
+        return minOfferCost==0 || j->estimatedCost()>=minOfferCost;
+    }
+
+    /* NOTE: the workerPool is not used with the circular queue, a parked   */
+    /* worker would have to be taken out of the middle of the queue         */
+    void setShare(const int&){
+    }
+
+    void enter(const int&){
+        currentWorkgroup = this;
+        uncounted = uncountedGroup;
+    }
+
+    void leave(const int&){
+        currentWorkgroup = nullptr;
+    }
+
+    bool overShare(const int&){
+        return false;
+    }
+
+    void park(const int&){
+    }
+
+    std::string getStatistics(){
+        return "";
+    }
+
     bool closed(){          /* return possibly closed, unnecessary but useful    */
         return A.full();
     }
 
+    bool idle(){            /* return possibly some worker waiting for a job     */
+        return !A.empty();
+    }
+
     bool isCompleted(){
         if( startingJob!=nullptr )
             return startingJob->completed();
@@ -558,13 +658,81 @@ private:
     std::atomic<int> d;
     job *startingJob;
     std::chrono::duration<double> lastDuration;
+    const bool locality;                        /* pin workers, offer near to data  */
+    std::vector<std::vector<int>> near;         /* near[id] : workers by distance   */
+    std::vector<std::atomic<int>> owner;        /* last worker touching a granule   */
+    std::atomic<uint64_t> nearOffers, farOffers;
+    uint64_t minOfferCost{0};                   /* cheaper jobs are kept local      */
+    const bool uncountedGroup{uncounted};
+    std::atomic<uint64_t> keptLocal;
+    int shareWeight{0};                         /* in the workerPool if not 0       */
+    workerPool::tenant tenant;
+    std::vector<char> holding;                  /* holding[id] : running in the pool*/
+    std::atomic<int> parked;                    /* workers neither working nor in A */
+    std::atomic<uint64_t> parks;
+    static constexpr int granuleShift{16}, ownerMask{(1<<12)-1};
+
+    static int granule(const void *p){
+        return static_cast<int>((reinterpret_cast<uintptr_t>(p)>>granuleShift) & ownerMask);
+    }
+
+    int lastToucher(job* const j){
+        auto r(j->getAffinity());
+        if( r.first==nullptr || r.second<=r.first )
+            return -1;
+        return owner[granule(r.first)].load(std::memory_order_relaxed);
+    }
+
+    void giveJob(const int& id, job* const j, const int& t){
+        d.fetch_sub(1, std::memory_order_relaxed);
+        J[id].store(j, std::memory_order_release);
+        if( t>=0 )
+            (cacheTopology::get().distance(t, id)<2 ? nearOffers : farOffers).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    cpu_set_t callerSet;                        /* worker 0 is the calling thread   */
+
+    void pinWorkers(){
+        if( !locality )
+            return;
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &callerSet);
+        cacheTopology::get().pin(0);
+        for( int i=1; i<n; ++i )
+            cacheTopology::get().pin(i, T[i].native_handle());
+    }
+
+    void unpinCaller(){
+        if( locality )
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &callerSet);
+    }
+
+    /* in the pool all workers but the caller start parked  */
+    void joinPool(){
+        if( shareWeight==0 ){
+            d.store(n-1, std::memory_order_relaxed);
+            parked.store(0, std::memory_order_relaxed);
+            return;
+        }
+        d.store(0, std::memory_order_relaxed);
+        parked.store(n-1, std::memory_order_relaxed);
+        tenant.weight = shareWeight;
+        workerPool::get().join(tenant, n);
+    }
 public:
-    explicit workgroup(int n) : done{false}, n(n), ready(false), working(ATOMIC_FLAG_INIT), T(n), J(n), W(), A(n), d(0) {
+    explicit workgroup(int n, bool locality = false) : done{false}, n(n), ready(false), working(ATOMIC_FLAG_INIT), T(n), J(n), W(), A(n), d(0),
+        locality(locality), near(n), owner(ownerMask+1), nearOffers(0), farOffers(0), keptLocal(0), holding(n, false), parked(0), parks(0) {
         for( int i=0; i<n; ++i ){
             W.emplace_back(i);
             J[i].store(nullptr);
             std::atomic_init(&A[i], false);
+            for( int k=0; k<n; ++k )
+                near[i].push_back(k);
+            std::stable_sort(near[i].begin(), near[i].end(), [i](const int& a, const int& b) -> bool {
+                return cacheTopology::get().distance(i, a) < cacheTopology::get().distance(i, b);
+            });
         }
+        for( auto &o: owner )
+            std::atomic_init(&o, -1);
     }
 
     bool start(job* const j, jobLogger& logMe, bool wthChrono = false){
@@ -573,11 +741,12 @@ public:
 
             J[0].store(j, std::memory_order_relaxed);
             A[0].store(false, std::memory_order_relaxed);
-            d.store(n-1, std::memory_order_relaxed);
+            joinPool();
             for( int i=1; i<n; ++i ){
-                A[i].store(true, std::memory_order_relaxed);
+                A[i].store(shareWeight==0, std::memory_order_relaxed);
                 T[i] = std::thread(&worker::startL, std::ref(W[i]), std::ref(*this), std::ref(logMe));
             }
+            pinWorkers();
             ready.store(true, std::memory_order_release);   /* Sync Release point   */
             if( wthChrono ){
                 lastDuration = W[0].startLWthChrono(*this, logMe).second;
@@ -592,6 +761,9 @@ public:
                 if( T[i].joinable() )
                     T[i].join();
             }
+            unpinCaller();
+            if( shareWeight!=0 )
+                workerPool::get().leave(tenant);
             ready.store(false, std::memory_order_relaxed);
             working.clear(std::memory_order_release);       /* Sync Release point   */
             return true;
@@ -605,11 +777,12 @@ public:
 
             J[0].store(j, std::memory_order_relaxed);
             A[0].store(false, std::memory_order_relaxed);
-            d.store(n-1, std::memory_order_relaxed);
+            joinPool();
             for( int i=1; i<n; ++i ){
-                A[i].store(true, std::memory_order_relaxed);
+                A[i].store(shareWeight==0, std::memory_order_relaxed);
                 T[i] = std::thread(&worker::start, std::ref(W[i]), std::ref(*this));
             }
+            pinWorkers();
             ready.store(true, std::memory_order_release);   /* Sync Release point   */
             if( wthChrono )
                 lastDuration = W[0].startWthChrono(*this).second;
@@ -622,6 +795,9 @@ public:
                 if( T[i].joinable() )
                     T[i].join();
             }
+            unpinCaller();
+            if( shareWeight!=0 )
+                workerPool::get().leave(tenant);
             ready.store(false, std::memory_order_relaxed);
             working.clear(std::memory_order_release);       /* Sync Release point   */
             return true;
@@ -661,18 +837,116 @@ public:
         while( (j = J[id].exchange(nullptr, std::memory_order_acquire)) == nullptr );
     }
 
+    /* with locality, idle workers are tried from the nearest, in terms of  */
+    /* shared caches, to the last one which touched the data of the job     */
     bool offerJob(job* const j){
+        int t{lastToucher(j)};
+        if( locality && t>=0 ){
+            for( auto &id: near[t] )
+                if( A[id].exchange(false, std::memory_order_relaxed) ){
+                    giveJob(id, j, t);
+                    return true;
+                }
+            return false;
+        }
         for( int id=0; id<n; ++id )
             if( A[id].exchange(false, std::memory_order_relaxed) ){
-                d.fetch_sub(1, std::memory_order_relaxed);
-                J[id].store(j, std::memory_order_release);
+                giveJob(id, j, t);
                 return true;
             }
         return false;
     }
 
+    void touch(const int& id, job* const j){
+        auto r(j->getAffinity());
+        if( r.first==nullptr || r.second<=r.first )
+            return;
+        uintptr_t b{reinterpret_cast<uintptr_t>(r.first)>>granuleShift}, e{(reinterpret_cast<uintptr_t>(r.second)-1)>>granuleShift};
+        uintptr_t step{std::max<uintptr_t>(1, (e-b)>>4)};
+        for( uintptr_t g=b; g<=e; g+=step )
+            owner[g & ownerMask].store(id, std::memory_order_relaxed);
+    }
+
+    /* jobs cheaper than cost are done by the worker which created them,    */
+    /* the hand-off to another core would cost more than the job itself     */
+    void setOfferCost(const uint64_t& cost){
+        minOfferCost = cost;
+    }
+
+    bool worthOffering(job* const j){
+        if( minOfferCost==0 || j->estimatedCost()>=minOfferCost )
+            return true;
+        keptLocal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /* weight of the workgroup among the tenants of the workerPool; with 0  */
+    /* (default) it is not in the pool and all its workers are running      */
+    void setShare(const int& weight){
+        shareWeight = weight;
+    }
+
+    /* a worker entering and leaving the cycle of the workgroup  */
+    void enter(const int& id){
+        currentWorkgroup = this;
+        uncounted = uncountedGroup;
+        enterPool(id);
+    }
+
+    void leave(const int& id){
+        leavePool(id);
+        currentWorkgroup = nullptr;
+    }
+
+    /* a worker runs only when the pool lets it, the caller always runs     */
+    void enterPool(const int& id){
+        if( shareWeight==0 || id==0 )
+            return;
+        if( workerPool::get().unpark(tenant, [this]() -> bool { return startingJob->completed(); }) ){
+            holding[id] = true;
+            A[id].store(true, std::memory_order_relaxed);
+            d.fetch_add(1, std::memory_order_relaxed);
+            parked.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void leavePool(const int& id){
+        if( holding[id] ){
+            holding[id] = false;
+            workerPool::get().release(tenant);
+        }
+    }
+
+    bool overShare(const int& id){
+        return shareWeight!=0 && id!=0 && tenant.over.load(std::memory_order_relaxed);
+    }
+
+    /* only an idle worker, out of A so that no job can reach it            */
+    void park(const int& id){
+        if( !A[id].exchange(false, std::memory_order_relaxed) )
+            return;
+        parked.fetch_add(1, std::memory_order_relaxed);
+        d.fetch_sub(1, std::memory_order_relaxed);
+        parks.fetch_add(1, std::memory_order_relaxed);
+        holding[id] = false;
+        workerPool::get().park(tenant);
+        enterPool(id);
+    }
+
+    /* offers of jobs with known data, near means sharing L2 or L3 with the */
+    /* last worker which touched them                                       */
+    std::string getStatistics(){
+        return "nearOffers="+std::to_string(nearOffers.load(std::memory_order_relaxed))+" farOffers="+std::to_string(farOffers.load(std::memory_order_relaxed))
+            +" keptLocal="+std::to_string(keptLocal.load(std::memory_order_relaxed))
+            +(shareWeight!=0 ? " parks="+std::to_string(parks.load(std::memory_order_relaxed)) : "");
+    }
+
     bool closed(){          /* return possibly closed, unnecessary but useful    */
-        return d.load(std::memory_order_relaxed)==n;
+        return d.load(std::memory_order_relaxed)+parked.load(std::memory_order_relaxed)==n;
+    }
+
+    bool idle(){            /* return possibly some worker waiting for a job     */
+        return d.load(std::memory_order_relaxed)>0;
     }
 
     bool isCompleted(){
@@ -721,3 +995,59 @@ public:
 };
 
 #endif
+
+/* A job helped by the idle workers of its workgroup: f(k) for every k  */
+/* in [0,n), indices are claimed one at a time by the caller and by the */
+/* helpers, so n should be a number of chunks rather than of elements;  */
+/* returns when all of them are done. Sequential outside a workgroup    */
+class forJob: public job{
+    std::function<void()> f;
+    std::atomic<bool> complete;
+    const uint64_t myJobId;
+public:
+    explicit forJob(std::function<void()> f) : f(f), complete(false), myJobId{jobId.fetch_add(1, std::memory_order_relaxed)} {}
+
+    void operator()() override {
+        f();
+        complete.store(true, std::memory_order_release);
+    }
+
+    bool completed() override {
+        return complete.load(std::memory_order_acquire);
+    }
+
+    bool inputReady() override {
+        return true;
+    }
+
+    uint64_t getJobId() override {
+        return myJobId;
+    }
+};
+
+/* true when parallelFor would find some help   */
+inline bool helpAvailable(){
+    return currentWorkgroup!=nullptr && currentWorkgroup->idle();
+}
+
+template <class F>
+void parallelFor(const int& n, F f){
+    std::atomic<int> next{0};
+    std::function<void()> run = [&](){
+        for( int k; (k=next.fetch_add(1, std::memory_order_relaxed))<n; )
+            f(k);
+    };
+    std::vector<forJob *> H;                    /* helpers: owned by who runs them  */
+    for( workgroup *g(currentWorkgroup); g!=nullptr && static_cast<int>(H.size())<n-1 && g->idle(); ){
+        forJob *h(new forJob(run));
+        if( !g->offerJob(h) ){
+            delete h;
+            break;
+        }
+        H.push_back(h);
+    }
+    run();
+    for( auto &h: H )
+        while( !h->completed() )
+            std::this_thread::yield();
+}
@@ -0,0 +1,173 @@
+/* License : Michele Miccinesi 2018 -       */
+/* Multiway mergesort components            */
+
+/* A range is divided in ways parts and impera merges them at once  */
+/* through a loser tree, so that the data go through memory         */
+/* log_ways(n/sortBlock) times instead of log2(n/sortBlock).        */
+/* All leaves are at the same level, so that the runs merged by an  */
+/* impera are all in the same buffer                                */
+
+/* 0: as many as fit in L2 with 16KB each, at least 2, at most 64    */
+int ways{0};
+
+inline int getWays(){
+    if( ways>1 )
+        return ways;
+    const long L2{sysconf(_SC_LEVEL2_CACHE_SIZE)};
+    return L2>0 ? static_cast<int>(std::max(2l, std::min(64l, L2>>14))) : 16;
+}
+
+template <typename T, typename I = sortIndex>
+struct subVector{
+    static int threshold;
+    const int depth;
+    subVector(int depth, dataVector<T>& V, dataVector<T>& W, const I& i, const I& j, const int& levels = -1) : depth(depth), V(V), W(W), i(i), j(j),
+        levels(levels>=0 ? levels : levelsFor(j-i+1)) {}
+    dataVector<T>& V, &W;
+    I i, j;
+    int levels;                         /* divisions left before the base blocks */
+
+    /* ways^levels parts of at most sortBlock elements   */
+    static int levelsFor(const I& n){
+        int l{0};
+        for( int64_t parts{1}; (n+parts-1)/parts>std::max(2, sortBlock); parts*=getWays() )
+            ++l;
+        return l;
+    }
+};
+
+template <typename T, typename I>
+int subVector<T, I>::threshold = -3;
+
+/* for locality aware placement of jobs */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V.data()+V.i, V.V.data()+V.j+1);
+}
+
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return sortCost(V.j-V.i+1);
+}
+
+/* a sorted run in memory, as a source of the loser tree: next gives */
+/* its elements in order, false when it is exhausted                 */
+template <class T>
+struct runRange{
+    const T *head{nullptr}, *end{nullptr};
+    runRange() {}
+    runRange(const T* head, const T* end) : head(head), end(end) {}
+
+    bool next(T& x){
+        if( head==end )
+            return false;
+        x = *head++;
+        return true;
+    }
+};
+
+/* Tournament of k sorted runs where each node keeps the loser of  */
+/* its match, with its key, and E[0] the winner: after the winner   */
+/* is taken, only the matches on the path of its run to the root    */
+/* are replayed; exhausted runs lose against all, ties go to the    */
+/* run first in order (stable). A default source must be empty      */
+template <class T, class source = runRange<T>>
+class loserTree{
+    struct entry{
+        T key;
+        int run;
+        bool done;
+    };
+    int K;
+    std::vector<entry> E;
+    std::vector<source> S;
+
+    static bool beats(const entry& a, const entry& b){
+        return !a.done && (b.done || a.key<b.key || (!(b.key<a.key) && a.run<b.run));
+    }
+
+    entry next(const int& r){
+        entry e{T(), r, false};
+        e.done = !S[r].next(e.key);
+        return e;
+    }
+
+    entry play(const int& node){
+        if( node>=K )
+            return next(node-K);
+        entry a(play(2*node)), b(play(2*node+1));
+        if( beats(b, a) )
+            std::swap(a, b);
+        E[node] = b;
+        return a;
+    }
+public:
+    loserTree(std::vector<source> runs) : K(1), S(std::move(runs)) {
+        while( K<static_cast<int>(S.size()) )
+            K *= 2;
+        E.resize(K);
+        S.resize(K);
+        E[0] = play(1);
+    }
+
+    /* up to m elements to out, where it stops is returned */
+    T* merge(T* out, std::size_t m = std::numeric_limits<std::size_t>::max()){
+        entry w(E[0]);
+        for( ; m>0 && !w.done; --m ){
+            *out++ = w.key;
+            w = next(w.run);
+            for( int node=(w.run+K)/2; node>0; node/=2 )
+                if( beats(E[node], w) )
+                    std::swap(E[node], w);
+        }
+        E[0] = w;
+        return out;
+    }
+
+    bool empty() const {
+        return E[0].done;
+    }
+};
+
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    std::vector<subVector<T, I>> Vout;
+    const I n{Vin.j-Vin.i+1};
+    const int k{getWays()};
+    for( int c=0; c<k; ++c ){
+        const I i{Vin.i+static_cast<I>(int64_t(n)*c/k)}, j{Vin.i+static_cast<I>(int64_t(n)*(c+1)/k)-1};
+        if( j>=i )
+            Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, i, j, Vin.levels-1);
+    }
+    return Vout;
+};
+
+/* two runs go through the merge kernel of the mergesorts */
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout (Vin[0].depth+1, Vin[0].W, Vin[0].V, Vin[0].i, Vin.back().j, Vin[0].levels+1);
+    if( Vin.size()==1 )
+        std::copy(Vin[0].V.begin()+Vin[0].i, Vin[0].V.begin()+Vin[0].j+1, Vout.V.begin()+Vout.i);
+    else if( Vin.size()==2 )
+        mergeRuns(Vin[0].V.data()+Vin[0].i, Vin[0].j-Vin[0].i+1, Vin[1].V.data()+Vin[1].i, Vin[1].j-Vin[1].i+1, Vout.V.data()+Vout.i);
+    else {
+        std::vector<runRange<T>> runs;
+        for( auto &v: Vin )
+            runs.emplace_back(v.V.data()+v.i, v.V.data()+v.j+1);
+        accountMerge(2*sizeof(T)*(Vout.j-Vout.i+1), [&](){ loserTree<T>(runs).merge(Vout.V.data()+Vout.i); });
+    }
+    return Vout;
+};
+
+/* blocks up to sortBlock elements, by a sorting network for ints */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout{Vin.depth, Vin.W, Vin.V, Vin.i, Vin.j, 0};
+    sortSmall(Vin.V.data()+Vin.i, Vout.V.data()+Vin.i, Vin.j-Vin.i+1);
+    return Vout;
+};
+
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.levels==0;
+};
@@ -2,66 +2,93 @@
 /* Mergesort components                     */
 
 
-template <typename T>
+/* With halfScratch the sorted ranges stay in V and W has only n/2    */
+/* elements: the left half, the smaller one, is copied out and merged  */
+/* back with the right one; the left half of [i,j] goes in W from      */
+/* (i+1)/2, so that concurrent merges use disjoint parts of W          */
+template <typename T, typename I = sortIndex>
 struct subVector{
     static int threshold;
+    static bool halfScratch;
     const int depth;
-    subVector(int depth, std::vector<T>& V, std::vector<T>& W, const int& i, const int &j) : depth(depth), V(V), W(W), i(i), j(j) {}
-    std::vector<T>& V, &W;
-    int i, j;
+    subVector(int depth, dataVector<T>& V, dataVector<T>& W, const I& i, const I& j) : depth(depth), V(V), W(W), i(i), j(j) {}
+    dataVector<T>& V, &W;
+    I i, j;
 };
 
-template <>
-int subVector<int>::threshold = -10;
+template <typename T, typename I>
+int subVector<T, I>::threshold = -10;
+template <typename T, typename I>
+bool subVector<T, I>::halfScratch = false;
 
-template <class T>
-auto divide = [](const subVector<T>& Vin) -> std::vector<subVector<T>>{
-    std::vector<subVector<T>> Vout;
+/* for locality aware placement of jobs */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V.data()+V.i, V.V.data()+V.j+1);
+}
+
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return sortCost(V.j-V.i+1);
+}
+
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    std::vector<subVector<T, I>> Vout;
+    if( subVector<T, I>::halfScratch ){
+        const I m{Vin.i+(Vin.j-Vin.i+1)/2};
+        Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, Vin.i, m-1);
+        Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, m, Vin.j);
+        return Vout;
+    }
     Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, Vin.i, (Vin.i+Vin.j)/2);
     Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, (Vin.i+Vin.j)/2+1, Vin.j);
     return Vout;
 };
 
-template <class T>
-auto impera = [](const std::vector<subVector<T>>& Vin) -> subVector<T>{
-    subVector<T> Vout (Vin[0].depth+1, Vin[0].W, Vin[0].V, Vin[0].i, Vin[1].j);
-    int ii[] = { Vin[0].i, Vin[1].i };
-    int i { Vin[0].i };  
-    while( true ){
-        bool b{Vin[0].V[ii[0]]>Vin[1].V[ii[1]]};
-        bool nb=!b;
-        Vout.V[i++]=Vin[b].V[ii[b]++];
-        if( ii[b]>Vin[b].j ){
-            while( ii[nb]<=Vin[nb].j )
-                Vout.V[i++]=Vin[nb].V[ii[nb]++];
-            break;
-        }
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    if( subVector<T, I>::halfScratch ){
+        mergeHalfScratch(Vin[0].V.data()+Vin[0].i, Vin[0].j-Vin[0].i+1, Vin[1].j-Vin[1].i+1, Vin[0].W.data()+(Vin[0].i+1)/2);
+        return subVector<T, I>(Vin[0].depth+1, Vin[0].V, Vin[0].W, Vin[0].i, Vin[1].j);
     }
+    subVector<T, I> Vout (Vin[0].depth+1, Vin[0].W, Vin[0].V, Vin[0].i, Vin[1].j);
+    mergeRuns(Vin[0].V.data()+Vin[0].i, Vin[0].j-Vin[0].i+1, Vin[1].V.data()+Vin[1].i, Vin[1].j-Vin[1].i+1, Vout.V.data()+Vin[0].i);
+
+    return Vout;
+};
 
+/* blocks up to sortBlock elements, by a sorting network for ints */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    if( subVector<T, I>::halfScratch ){
+        sortSmall(Vin.V.data()+Vin.i, Vin.V.data()+Vin.i, Vin.j-Vin.i+1);
+        return Vin;
+    }
+    subVector<T, I> Vout{Vin.depth, Vin.W, Vin.V, Vin.i, Vin.j};
+    sortSmall(Vin.V.data()+Vin.i, Vout.V.data()+Vin.i, Vin.j-Vin.i+1);
     return Vout;
 };
 
-template <class T>
-auto base = [](const subVector<T>& Vin) -> subVector<T>{
-    subVector<T> Vout{Vin.depth, Vin.W, Vin.V, Vin.i, Vin.j};
-    switch(Vin.j-Vin.i){
-    case 1:
-        if( Vin.V[Vin.i]>Vin.V[Vin.j] ){
-            Vout.V[Vin.i]=Vin.V[Vin.j];
-            Vout.V[Vin.j]=Vin.V[Vin.i];
-        } else {
-            Vout.V[Vin.i]=Vin.V[Vin.i];
-            Vout.V[Vin.j]=Vin.V[Vin.j];
-        }
-        break;
-    case 0:
-        Vout.V[Vin.i]=Vin.V[Vin.i];
-        break;
-    } 
+/* base of a batch of sibling leaves, branchless for pairs   */
+template <class T, class I>
+auto baseBatch = [](const std::vector<subVector<T, I>>& Vin) -> std::vector<subVector<T, I>>{
+    std::vector<subVector<T, I>> Vout;
+    Vout.reserve(Vin.size());
+    for( auto &v: Vin ){
+        dataVector<T>& out(subVector<T, I>::halfScratch ? v.V : v.W);
+        Vout.emplace_back(v.depth, out, subVector<T, I>::halfScratch ? v.W : v.V, v.i, v.j);
+        if( v.j-v.i==1 ){
+            const T a(v.V[v.i]), b(v.V[v.j]);
+            out[v.i] = std::min(a, b);
+            out[v.j] = std::max(a, b);
+        } else
+            sortSmall(v.V.data()+v.i, out.data()+v.i, v.j-v.i+1);
+    }
     return Vout;
 };
 
-template <class T>
-auto isBase = [](const subVector<T>& V) -> bool{
-    return V.j-V.i<2;
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.j-V.i+1<=std::max(2, sortBlock);
 };
\ No newline at end of file
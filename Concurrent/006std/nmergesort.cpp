@@ -0,0 +1,168 @@
+/* License : Michele Miccinesi 2018 -       */
+/* Natural mergesort components             */
+
+/* The first division scans the input for runs, in chunks helped by    */
+/* idle workers: non decreasing runs are kept, strictly decreasing     */
+/* ones reversed (so it stays stable), runs shorter than sortBlock     */
+/* are extended by sortSmall; runs meeting at the chunk bounds in order */
+/* are joined. Then, as in powersort, the range is divided at the       */
+/* bound between runs of least power (the first bit where the midpoints */
+/* of the two runs differ, as fractions of n), so that the merge tree   */
+/* is balanced in elements rather than in runs, and a run is a leaf:    */
+/* a sorted input is scanned and not moved                              */
+
+/* S[r] the start of run r, S[k] the end of the k runs; P[r] the power */
+/* of the bound between runs r and r+1. They are dataVectors of at      */
+/* least runCapacity elements given with the whole range, so that they  */
+/* are shared as the data with processes                                 */
+template <typename T, typename I = sortIndex>
+struct subVector{
+    static int threshold;
+    const I depth;
+    subVector(dataVector<T>& V, dataVector<T>& W, dataVector<I>& S, dataVector<int>& P, const I& i, const I& j, const bool& scanned = false, const I& r0 = 0, const I& r1 = 0) :
+        depth(j-i+1), V(V), W(W), S(S), P(P), i(i), j(j), scanned(scanned), r0(r0), r1(r1) {}
+    dataVector<T>& V, &W;
+    dataVector<I>& S;
+    dataVector<int>& P;
+    I i, j;
+    bool scanned;                       /* S and P are set          */
+    I r0, r1;                           /* the runs [r0,r1]         */
+
+    /* runs are at least sortBlock long, but the last of a chunk    */
+    static I runCapacity(const I& n){
+        return n/std::max(2, sortBlock)+66;
+    }
+};
+
+template <typename T, typename I>
+int subVector<T, I>::threshold = 1<<14;
+
+/* runs found by the last sort, not by the other tenants */
+std::atomic<int64_t> runsFound{0};
+
+/* for locality aware placement of jobs */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V.data()+V.i, V.V.data()+V.j+1);
+}
+
+/* a single run costs nothing */
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return V.scanned && V.r0==V.r1 ? 0 : sortCost(V.j-V.i+1);
+}
+
+/* first bit where a/2n and b/2n differ, a<b<2n: the integer parts */
+/* are dropped as the bits go, so nothing overflows                  */
+inline int boundPower(uint64_t a, uint64_t b, const uint64_t& n){
+    for( int p=1; ; ++p ){
+        a *= 2;
+        b *= 2;
+        if( b<2*n )
+            continue;
+        if( a<2*n )
+            return p;
+        a -= 2*n;
+        b -= 2*n;
+    }
+}
+
+/* starts of the runs of V[b,e), made non decreasing in place */
+template <class T, class I>
+void scanRuns(T* V, const I& b, const I& e, std::vector<I>& S){
+    const int minRun{std::max(2, sortBlock)};
+    for( I x=b; x<e; ){
+        S.push_back(x);
+        I y{x+1};
+        if( y<e && V[y]<V[x] ){
+            while( y<e && V[y]<V[y-1] )
+                ++y;
+            std::reverse(V+x, V+y);
+        } else
+            while( y<e && !(V[y]<V[y-1]) )
+                ++y;
+        if( y-x<minRun && y<e ){
+            y = std::min<I>(e, x+minRun);
+            sortSmall(V+x, V+x, y-x);
+            while( y<e && !(V[y]<V[y-1]) )
+                ++y;
+        }
+        x = y;
+    }
+}
+
+/* the number of runs of Vin, set in S and P */
+template <class T, class I>
+I findRuns(const subVector<T, I>& Vin){
+    const I n{Vin.j-Vin.i+1};
+    const int nC{static_cast<int>(std::max<I>(1, std::min<I>(64, n>>16)))};
+    T *V(Vin.V.data());
+    auto chunk = [&](const int& c) -> I { return Vin.i+static_cast<I>(int64_t(n)*c/nC); };
+    std::vector<std::vector<I>> C(nC);
+    parallelFor(nC, [&](int c){
+        scanRuns(V, chunk(c), chunk(c+1), C[c]);
+    });
+
+    I k{0};
+    for( int c=0; c<nC; ++c )
+        for( auto &s: C[c] )
+            if( s!=chunk(c) || c==0 || V[s]<V[s-1] )
+                Vin.S[k++] = s;
+    Vin.S[k] = Vin.j+1;
+    for( I r=0; r+1<k; ++r )
+        Vin.P[r] = boundPower(Vin.S[r]+Vin.S[r+1]-2*Vin.i, Vin.S[r+1]+Vin.S[r+2]-2*Vin.i, n);
+    if( !uncounted )
+        runsFound = k;
+    return k;
+}
+
+/* the runs [r0,r1] of Vin divided at the bound of least power, the */
+/* first one on ties                                                 */
+template <class T, class I>
+std::vector<subVector<T, I>> splitRuns(const subVector<T, I>& Vin){
+    std::vector<subVector<T, I>> Vout;
+    I m{Vin.r0};
+    for( I r=Vin.r0+1; r<Vin.r1; ++r )
+        if( Vin.P[r]<Vin.P[m] )
+            m = r;
+    Vout.emplace_back(Vin.V, Vin.W, Vin.S, Vin.P, Vin.i, Vin.S[m+1]-1, true, Vin.r0, m);
+    Vout.emplace_back(Vin.V, Vin.W, Vin.S, Vin.P, Vin.S[m+1], Vin.j, true, m+1, Vin.r1);
+    return Vout;
+}
+
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    if( Vin.scanned )
+        return splitRuns(Vin);
+    const I k{findRuns(Vin)};
+    const subVector<T, I> runs(Vin.V, Vin.W, Vin.S, Vin.P, Vin.i, Vin.j, true, 0, k-1);
+    return k>1 ? splitRuns(runs) : std::vector<subVector<T, I>>(1, runs);
+};
+
+/* the runs end in either buffer: when the two parts are not in the */
+/* same one, the smaller part is copied to the buffer of the other   */
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    if( Vin.size()==1 )
+        return Vin[0];
+    const subVector<T, I> &L(Vin[0]), &R(Vin[1]);
+    const I nL{L.j-L.i+1}, nR{R.j-R.i+1};
+    dataVector<T> &in(nL>=nR ? L.V : R.V), &out(nL>=nR ? L.W : R.W);
+    if( &L.V!=&in )
+        std::copy(L.V.begin()+L.i, L.V.begin()+L.j+1, in.begin()+L.i);
+    if( &R.V!=&in )
+        std::copy(R.V.begin()+R.i, R.V.begin()+R.j+1, in.begin()+R.i);
+    mergeRuns(in.data()+L.i, nL, in.data()+R.i, nR, out.data()+L.i);
+    return subVector<T, I>(out, in, L.S, L.P, L.i, R.j, true, L.r0, R.r1);
+};
+
+/* a run is already sorted where it is */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    return Vin;
+};
+
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.scanned ? V.r0==V.r1 : V.j-V.i<1;
+};
@@ -32,13 +32,14 @@ struct test{
     std::random_device r;
     std::seed_seq seed1;
     std::mt19937 e1;
+    uint64_t seed;                              /* of the generated inputs  */
 
-    enum class reportable : uint32_t { null=0, threads=1, size=2, threshold=4, chrono=8, parameters=16 };
+    enum class reportable : uint32_t { null=0, threads=1, size=2, threshold=4, chrono=8, parameters=16, statistics=32, cacheMisses=64, speedup=128, branchMisses=256, nsPerElement=512, mergeThroughput=1024, bytesMoved=2048, peakMemory=4096 };
     friend reportable operator&(const reportable& a, const reportable& b){
         return reportable(uint32_t(a) & uint32_t(b));
     }
 
-    enum class algorithm { unspecified, mergesort, umergesort, quicksort, pmergesort };
+    enum class algorithm { unspecified, mergesort, umergesort, quicksort, pmergesort, samplesort, radixsort, kmergesort, extsort, nmergesort, select, partialsort };
 
     algorithm testName;
     std::string getTestName(){
@@ -53,23 +54,54 @@ struct test{
             return "quicksort";
         case algorithm::pmergesort:
             return "pmergesort";
+        case algorithm::samplesort:
+            return "samplesort";
+        case algorithm::radixsort:
+            return "radixsort";
+        case algorithm::kmergesort:
+            return "kmergesort";
+        case algorithm::extsort:
+            return "extsort";
+        case algorithm::nmergesort:
+            return "nmergesort";
+        case algorithm::select:
+            return "select";
+        case algorithm::partialsort:
+            return "partialsort";
         default:
             return "noname";
         }
     }
 
-    bool chronometer{false}, result{false}, uniqueResultFile{false};
+    bool chronometer{false}, result{false}, uniqueResultFile{false}, processes{false}, lazy{false}, locality{false}, batch{false}, verify{false};
+    bool binaryInput{false};                    /* random inputs generated as binary data files  */
 
     jobLogger* logMe{nullptr};
     int logSize{(1<<14)-1};
+    uint64_t offerCost{0};
     uint32_t toBeLogged{0};
     
     std::vector<std::string> inputFiles, resultFile;
     std::vector<int> threads;
+    std::vector<int> tenants;                   /* weights in the workerPool    */
+    std::vector<std::thread> otherTenants;
     std::string reportFile, logFile;
     reportable reportSpec{ reportable{0} };
 
-    test() : testName(algorithm::unspecified), seed1{r(), r(), r(), r(), r(), r(), r(), r()}, e1(seed1) {}
+    /* last level cache misses of the run, including those of the workers   */
+    perfCounter llcMisses{ perfCounter::event::cacheMisses }, brMisses{ perfCounter::event::branchMisses };
+    std::string lastCacheMisses, lastBranchMisses;
+    peakMemory memory;
+    std::string lastPeakMemory;
+    multisetHash inputHash;                     /* of the input of the runs to be verified  */
+
+    /* records of recordBytes bytes, made from the keys of the input, */
+    /* sorted whole or, indirect, as (key, index) pairs, then permuted */
+    std::size_t recordBytes{100};
+    std::vector<char> records, permuted;
+    std::string extractTime;
+
+    test() : testName(algorithm::unspecified), seed1{r(), r(), r(), r(), r(), r(), r(), r()}, e1(seed1), seed((uint64_t(e1())<<32)|e1()) {}
 
     template <class T>
     void parseDataT(std::string s, int i){
@@ -78,6 +110,7 @@ struct test{
 
         std::vector<int> rndSizes;
         auto distribution(uniformDist<T>::get());
+        const std::size_t named{inputFiles.size()};
         if( s[i]=='[' ){
             if( ++i>=s.size() )
                 return;
@@ -91,12 +124,22 @@ struct test{
         else
             rndSizes.emplace_back(read<int>(s, i));
 
+        /* generated inputs are in memory, .bin marks binary results */
+        for( std::size_t f=named; f<inputFiles.size(); ++f )
+            if( isGeneratedInput(inputFiles[f]) && binaryInput )
+                inputFiles[f] += ".bin";
         for( auto &sz: rndSizes ){
-            inputFiles.push_back("mergesort"+std::to_string(sz)+"sz.input");
+            inputFiles.push_back("mergesort"+std::to_string(sz)+(binaryInput ? "sz.bin" : "sz.input"));
             std::ofstream file;
-            file.open(inputFiles.back(), std::ios::trunc);
-            for( int n=0; n<sz; ++n )
-                file << distribution(e1) << ' ';
+            file.open(inputFiles.back(), std::ios::trunc | std::ios::binary);
+            if( binaryInput ){
+                std::vector<T> V(sz);
+                for( auto &v: V )
+                    v = distribution(e1);
+                writeData(file, V.data(), V.size());
+            } else
+                for( int n=0; n<sz; ++n )
+                    file << distribution(e1) << ' ';
         }
     }
     
@@ -107,27 +150,75 @@ struct test{
     };
     virtual bool start() = 0;
 
-    void printReport(std::ofstream& out, std::string _nthread, std::string _size, std::string _threshold, std::string _chrono, std::string _parameters){
+    /* a line of the report, its fields as in reportable, empty if unknown */
+    struct reportRow{
+        std::string threads, size, threshold, chrono, parameters, statistics, cacheMisses, speedup, branchMisses, nsPerElement, mergeThroughput, bytesMoved, peakMemory;
+    };
+
+    /* only the fields in reportSpec, each followed by ';'  */
+    void printReport(std::ofstream& out, const reportRow& row){
         if( !reportFile.empty() && (reportSpec != reportable::null)){
             if( (reportSpec & reportable::threads) != reportable::null ){
-                out << _nthread << ';';
+                out << row.threads << ';';
             }
             if( (reportSpec & reportable::size) != reportable::null ){
-                out << _size << ';';
+                out << row.size << ';';
             }
             if( (reportSpec & reportable::threshold) != reportable::null ){
-                out << _threshold << ';';
+                out << row.threshold << ';';
             }
             if( (reportSpec & reportable::chrono) != reportable::null ){
-                out << _chrono << ';';
+                out << row.chrono << ';';
             }
             if( (reportSpec & reportable::parameters) != reportable::null ){
-                out << _parameters << ';';
+                out << row.parameters << ';';
+            }
+            if( (reportSpec & reportable::statistics) != reportable::null ){
+                out << row.statistics << ';';
+            }
+            if( (reportSpec & reportable::cacheMisses) != reportable::null ){
+                out << row.cacheMisses << ';';
+            }
+            if( (reportSpec & reportable::speedup) != reportable::null ){
+                out << row.speedup << ';';
+            }
+            if( (reportSpec & reportable::branchMisses) != reportable::null ){
+                out << row.branchMisses << ';';
+            }
+            if( (reportSpec & reportable::nsPerElement) != reportable::null ){
+                out << row.nsPerElement << ';';
+            }
+            if( (reportSpec & reportable::mergeThroughput) != reportable::null ){
+                out << row.mergeThroughput << ';';
+            }
+            if( (reportSpec & reportable::bytesMoved) != reportable::null ){
+                out << row.bytesMoved << ';';
+            }
+            if( (reportSpec & reportable::peakMemory) != reportable::null ){
+                out << row.peakMemory << ';';
             }
             out << '\n';
         }   
     }
 
+    /* the row of a run of n elements, but the parameters and the statistics */
+    template <class H>
+    reportRow runReport(const int& nThreads, const std::size_t& n, const H& threshold, const std::chrono::duration<double>& duration){
+        reportRow row;
+        row.threads = std::to_string(nThreads);
+        row.size = std::to_string(n);
+        row.threshold = std::to_string(threshold);
+        row.chrono = chronometer ? std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()) : "";
+        row.cacheMisses = lastCacheMisses;
+        row.speedup = speedup(nThreads, duration);
+        row.branchMisses = lastBranchMisses;
+        row.nsPerElement = nsPerElement(n, duration);
+        row.mergeThroughput = mergeThroughput();
+        row.bytesMoved = bytesMoved();
+        row.peakMemory = lastPeakMemory;
+        return row;
+    }
+
     void prepare(std::ofstream& resultF, std::ofstream& reportF){
         if( !logFile.empty() ){
             if( logMe )
@@ -139,30 +230,287 @@ struct test{
         }
 
         if( uniqueResultFile )
-            resultF.open( resultFile.back(), std::ios::trunc );
+            resultF.open( resultFile.back(), std::ios::trunc | std::ios::binary );
 
         if( !reportFile.empty() && (reportSpec != reportable::null)){
             reportF.open(reportFile, std::ios::app);
-            printReport(reportF, "threads", "size", "threshold", "chrono(ms)", "parameters");
+            printReport(reportF, reportRow{"threads", "size", "threshold", "chrono(ms)", "parameters", "statistics", "cacheMisses", "speedup", "branchMisses", "ns/element", "merge(GB/s/core)", "bytesMoved", "peakMemory(KB)"});
+        }
+
+        /* workers which are processes see only buffers in shared memory    */
+        shareBuffers.store(processes, std::memory_order_relaxed);
+        if( processes && !tenants.empty() ){
+            std::cout << "Warning: tenants is not available with processes!" << std::endl;
+            tenants.clear();
+        }
+    }
+
+    /* the reported run is the first tenant, the others are the same run on */
+    /* their own copy of the data, concurrently and without any output      */
+    int share(){
+        return tenants.empty() ? 0 : tenants[0];
+    }
+
+    /* the options of a run, the same for the reported one and for the */
+    /* other tenants                                                    */
+    template <class D>
+    void configure(D& d, const int& weight){
+        d.setLazy(lazy);
+        d.setLocality(locality);
+        d.setOfferCost(offerCost);
+        d.setShare(weight);
+    }
+
+    /* the other tenants are uncounted: their merges, runs... are not in */
+    /* the report, while cacheMisses, branchMisses and peakMemory are of */
+    /* the whole process                                                  */
+    template <class F>
+    void startTenants(F run){
+        for( std::size_t t=1; t<tenants.size(); ++t )
+            otherTenants.emplace_back([run](int weight){
+                uncounted = true;
+                run(weight);
+            }, tenants[t]);
+    }
+
+    void joinTenants(){
+        for( auto &t: otherTenants )
+            t.join();
+        otherTenants.clear();
+    }
+
+    /* around each run: counters only measure what is between them  */
+    void beginRun(){
+        timeMerges = (reportSpec & reportable::mergeThroughput) != reportable::null;
+        countMerges = (reportSpec & reportable::bytesMoved) != reportable::null;
+        mergedBytes.store(0, std::memory_order_relaxed);
+        mergeNanos.store(0, std::memory_order_relaxed);
+        if( (reportSpec & reportable::cacheMisses) != reportable::null )
+            llcMisses.start();
+        if( (reportSpec & reportable::branchMisses) != reportable::null )
+            brMisses.start();
+        if( (reportSpec & reportable::peakMemory) != reportable::null )
+            memory.start();
+    }
+
+    void endRun(){
+        if( (reportSpec & reportable::cacheMisses) != reportable::null )
+            lastCacheMisses = llcMisses.stop();
+        if( (reportSpec & reportable::branchMisses) != reportable::null )
+            lastBranchMisses = brMisses.stop();
+        if( (reportSpec & reportable::peakMemory) != reportable::null )
+            lastPeakMemory = memory.stop();
+    }
+
+    /* only merges done in this process, empty if none  */
+    std::string mergeThroughput(){
+        const uint64_t ns{mergeNanos.load(std::memory_order_relaxed)};
+        return ns>0 ? std::to_string(double(mergedBytes.load(std::memory_order_relaxed))/ns) : "";
+    }
+
+    std::string bytesMoved(){
+        const uint64_t bytes{mergedBytes.load(std::memory_order_relaxed)};
+        return bytes>0 ? std::to_string(bytes) : "";
+    }
+
+    std::string nsPerElement(const std::size_t& n, const std::chrono::duration<double>& t){
+        if( !chronometer || n==0 )
+            return "";
+        return std::to_string(t.count()*1e9/n);
+    }
+
+    /* with respect to the run with the first of threads, same input and threshold */
+    double speedupBase{0};
+    std::string speedup(const int& nThreads, const std::chrono::duration<double>& t){
+        if( !chronometer )
+            return "";
+        if( nThreads==threads.front() )
+            speedupBase = t.count();
+        return t.count()>0 ? std::to_string(speedupBase/t.count()) : "";
+    }
+    /* a binary data file (*.bin), a generated input (distribution:size)  */
+    /* or text, elements separated by spaces                              */
+    template <class T>
+    void readInput(const std::string& filename, std::vector<T>& V){
+        if( isGeneratedInput(filename) ){
+            generateInput(filename, seed, V);
+            return;
+        }
+        if( isBinaryFile(filename) ){
+            mappedData<T> data(filename);
+            V.assign(data.data(), data.data()+data.size());
+            return;
         }
+        std::ifstream file;
+        file.open(filename);
+        for( T v; file >> v; V.emplace_back(v) );
+        file.close();
     }
+
+    template <int bytes>
+    void readInput(const std::string& filename, std::vector<record<bytes>>& V){
+        std::vector<int> keys;
+        readInput(filename, keys);
+        makeRecords(keys, V);
+    }
+
+    /* the records are kept aside and their pairs sorted */
+    void readInput(const std::string& filename, std::vector<keyIndex>& V){
+        std::vector<int> keys;
+        readInput(filename, keys);
+        makeRecords(keys, records, recordBytes);
+        const auto begin(std::chrono::steady_clock::now());
+        keyIndices(records, recordBytes, V);
+        extractTime = " extractUs="+std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-begin).count());
+    }
+
+    /* indirect: the records permuted as the sorted pairs P, with the */
+    /* times of the pairs made and of the permutation; nothing else   */
+    template <class T>
+    std::string permuteStatistics(const T*, const std::size_t&){
+        return "";
+    }
+
+    std::string permuteStatistics(const keyIndex* P, const std::size_t& n){
+        permuted.resize(records.size());
+        const auto begin(std::chrono::steady_clock::now());
+        permuteRecords(P, n, records.data(), permuted.data(), recordBytes);
+        std::string statistics(extractTime+" permuteUs="+std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-begin).count()));
+        if( verify ){
+            const std::size_t x{firstMispermuted(P, n, permuted.data(), recordBytes)};
+            if( x<n )
+                std::cout << "Warning: the record " << x << " is not the one of its pair!" << std::endl;
+            statistics += x<n ? " permuted=0" : " permuted=1";
+        }
+        return statistics;
+    }
+
+    /* as the result file: a binary data file, with a single write, or text */
+    template <class C>
+    void writeResult(std::ofstream& resultF, const C& V){
+        if( isBinaryFile(resultFile.back()) )
+            writeData(resultF, V.data(), V.size());
+        else
+            for( auto &o: V )
+                resultF << o << ' ';
+    }
+
+    template <class T>
+    void hashInput(const std::vector<T>& V){
+        if( verify )
+            inputHash = hashMultiset(V.data(), V.size());
+    }
+
+    /* " verified=1" if the output is a permutation of the input with the */
+    /* ranks [lo,hi] in place, " verified=0" and why on the console if not */
+    std::string verifyOutcome(const std::size_t& misplaced, const std::size_t& n, const multisetHash& outputHash){
+        bool verified{true};
+        if( misplaced<n ){
+            std::cout << "Warning: the output is not in order at " << misplaced << "!" << std::endl;
+            verified = false;
+        }
+        if( outputHash!=inputHash ){
+            std::cout << "Warning: the output is not a permutation of the input!" << std::endl;
+            verified = false;
+        }
+        return verified ? " verified=1" : " verified=0";
+    }
+
+    template <class T>
+    std::string verifyRun(const T* V, const std::size_t& n, const int64_t& lo = 0, const int64_t& hi = std::numeric_limits<int64_t>::max()){
+        return verify ? verifyOutcome(firstMisplaced(V, n, lo, hi), n, hashMultiset(V, n)) : "";
+    }
+
     template <class T>
     void newResultFile(std::ofstream& resultF, const std::string& inFilename, const int& nThreads, const T& threshold){
         if( !uniqueResultFile && result ){
             if( resultF.is_open() )
                 resultF.close();
 
+            /* zipf:1.5:1e6 gives zipf_1_5_1e6_  */
+            const bool generated{isGeneratedInput(inFilename)};
+            const std::string name(generated && isBinaryFile(inFilename) ? inFilename.substr(0, inFilename.size()-4) : inFilename);
             std::string newFilename;
-            newFilename+=inFilename[0];
-            for( int i=1; i<inFilename.size(); ++i ){
-                if( inFilename[i]=='.' )
+            newFilename+=name[0];
+            for( int i=1; i<name.size(); ++i ){
+                if( name[i]=='.' && !generated )
                     break;
-                newFilename += inFilename[i];
+                newFilename += name[i]==':' || name[i]=='.' ? '_' : name[i];
             }
-            newFilename += std::to_string(nThreads)+"thd"+std::to_string(threshold)+"tsh.output";
+            if( generated )
+                newFilename += '_';
+            newFilename += std::to_string(nThreads)+"thd"+std::to_string(threshold)+(isBinaryFile(inFilename) ? "tsh.bin" : "tsh.output");
             resultFile.emplace_back(newFilename);
-            resultF.open(newFilename, std::ios::trunc);
+            resultF.open(newFilename, std::ios::trunc | std::ios::binary);
+        }
+    }
+
+    /* what a test adds to the runs of its sort, all optional   */
+    template <class T, class R>
+    struct runHooks{
+        std::function<std::vector<R>(const std::vector<R>&)> leafBatch;    /* of the batched leaves    */
+        std::function<std::string(const std::vector<T>&)> input;           /* per input, to its runs   */
+        std::function<void()> before;                                      /* before the reported run  */
+        std::function<std::string(const R&)> statistics;                   /* of the reported run      */
+        int64_t low{0}, high{std::numeric_limits<int64_t>::max()};         /* ranks verified in place  */
+    };
+
+    /* every input, threshold and number of threads, the same steps and */
+    /* options for all the tests but extsort and pmergesort: a B holds  */
+    /* the buffers of a run of V and its whole range in B::range, while */
+    /* makeSort() gives the divImp of the algorithm                      */
+    template <class B, class T, class R, class S>
+    bool runSorts(std::vector<int>& thresholds, const int& defaultThreshold, S makeSort, runHooks<T, R>& hooks){
+        std::ofstream resultF;
+        std::ofstream reportF;
+        prepare( resultF, reportF );
+
+        for( auto &filename: inputFiles ){
+            std::vector<T> V;
+
+            readInput(filename, V);
+            hashInput(V);
+            const std::string inputStatistics(hooks.input ? hooks.input(V) : "");
+            if( thresholds.empty() )
+                thresholds.emplace_back(defaultThreshold);
+            for( auto &threshold: thresholds ){
+                for( auto &nThreads: threads ){
+                    B buffers(V);
+                    buffers.range.threshold = threshold;
+                    auto sorting(makeSort());
+                    configure(sorting, share());
+                    sorting.setLeafBatching(batch, hooks.leafBatch);
+
+                    newResultFile(resultF, filename, nThreads, threshold);
+
+                    startTenants([&](int weight){
+                        B buffers(V);
+                        auto tenant(makeSort());
+                        configure(tenant, weight);
+                        tenant.setLeafBatching(batch, hooks.leafBatch);
+                        tenant.start(buffers.range, nThreads, nullptr);
+                    });
+                    if( hooks.before )
+                        hooks.before();
+                    beginRun();
+                    const R sorted(processes ? sorting.startProcesses(buffers.range, nThreads, logMe, chronometer) : sorting.start(buffers.range, nThreads, logMe, chronometer));
+                    endRun();
+                    joinTenants();
+                    if( result ){
+                        writeResult(resultF, sorted.V);
+                        resultF.flush();
+                    }
+
+                    reportRow row(runReport(nThreads, V.size(), threshold, sorting.getDuration()));
+                    row.statistics = sorting.getStatistics()+(hooks.statistics ? hooks.statistics(sorted) : "")+inputStatistics+verifyRun(sorted.V.data()+sorted.i, sorted.j-sorted.i+1, hooks.low, hooks.high)+permuteStatistics(sorted.V.data()+sorted.i, sorted.j-sorted.i+1);
+                    printReport(reportF, row);
+                }
+            }
         }
+        if( reportF.is_open() )
+            reportF.flush();
+
+        return true;
     }
 
     virtual ~test(){
@@ -171,70 +519,117 @@ struct test{
     }
 };
 
-template <class T>
+template <class T, class I = sortIndex>
 struct mergeSortTest : test{
     std::vector<int> thresholds;
 
     mergeSortTest() {
         testName = algorithm::mergesort;
     }
+    virtual bool parseSpecificParameters(std::string s) override {
+        if( s=="half" ){
+            mergeSort::subVector<T, I>::halfScratch = true;
+            return true;
+        }
+        return false;
+    }
     virtual void parseThreshold(std::string s, int i) override {
         if( readList<int>(thresholds, s, i)==i )
             thresholds.push_back(read<int>(s, i));
     }
     virtual void parseData(std::string s, int i) override {
-        parseDataT<T>(s, i);
+        parseDataT<typename inputOf<T>::type>(s, i);
     }
+    /* the buffers of a run, half the scratch with half */
+    struct buffers{
+        dataVector<T> V1, V2;
+        mergeSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), V2(mergeSort::subVector<T, I>::halfScratch ? (V1.size()+1)/2 : V1.size()), range(0, V1, V2, 0, V1.size()-1) {}
+    };
     virtual bool start(){
-        std::ofstream resultF;
-        std::ofstream reportF;
-        prepare( resultF, reportF );
-
         using namespace mergeSort;
-        for( auto &filename: inputFiles ){
-            std::vector<T> V;
-            
-            {
-                std::ifstream file;
-                file.open(filename);
-                for( T v; file >> v; V.emplace_back(v) );
-                file.close();
-            }
+        runHooks<T, subVector<T, I>> hooks;
+        hooks.leafBatch = baseBatch<T, I>;
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
+    }
+};
 
-            if( thresholds.empty() )
-                thresholds.emplace_back(subVector<T>::threshold);
-            for( auto &threshold: thresholds ){
-                for( auto &nThreads: threads ){
-                    std::vector<T> V1(V), V2(V1.size());
-                    subVector<T> fullRange(0, V1, V2, 0, V1.size()-1);
-                    fullRange.threshold = threshold;
-                    divImp::divImp<subVector<T>, subVector<T>> mergesort(divide<T>, impera<T>, base<T>, isBase<T>);
-                    
-                    newResultFile(resultF, filename, nThreads, threshold);
-                    
-                    if( result ){
-                        for( auto &o: mergesort.start(fullRange, nThreads, logMe, chronometer).V )
-                            resultF << o << ' ';
-                        resultF.flush();
-                    } else 
-                        mergesort.start(fullRange, nThreads, logMe, chronometer);
+template <class T, class I = sortIndex>
+struct kMergeSortTest : test{
+    std::vector<int> thresholds;
 
-                    printReport( reportF, std::to_string(nThreads), std::to_string(V.size()), std::to_string(threshold), 
-                        chronometer?std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(mergesort.getDuration()).count()):"", "");
-                }
-            }
+    kMergeSortTest() {
+        testName = algorithm::kmergesort;
+    }
+    virtual bool parseSpecificParameters(std::string s) override {
+        if( preMatch("ways=", s) ){
+            kMergeSort::ways = std::max(0, std::min(64, std::stoi(s.substr(5))));
+            return true;
         }
-        if( reportF.is_open() )
-            reportF.flush();
+        return false;
+    }
+    virtual void parseThreshold(std::string s, int i) override {
+        if( readList<int>(thresholds, s, i)==i )
+            thresholds.push_back(read<int>(s, i));
+    }
+    virtual void parseData(std::string s, int i) override {
+        parseDataT<typename inputOf<T>::type>(s, i);
+    }
+    struct buffers{
+        dataVector<T> V1, V2;
+        kMergeSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), V2(V1.size()), range(0, V1, V2, 0, V1.size()-1) {}
+    };
+    virtual bool start(){
+        using namespace kMergeSort;
+        runHooks<T, subVector<T, I>> hooks;
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
+    }
+};
 
-        return true;
+template <class T, class I = sortIndex>
+struct nMergeSortTest : test{
+    std::vector<int> thresholds;
+
+    nMergeSortTest() {
+        testName = algorithm::nmergesort;
+    }
+    virtual void parseThreshold(std::string s, int i) override {
+        if( readList<int>(thresholds, s, i)==i )
+            thresholds.push_back(read<int>(s, i));
+    }
+    virtual void parseData(std::string s, int i) override {
+        parseDataT<typename inputOf<T>::type>(s, i);
+    }
+    /* with the starts of the runs found, S, and their merge plan, P */
+    struct buffers{
+        dataVector<T> V1, V2;
+        dataVector<I> S;
+        dataVector<int> P;
+        natMergeSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), V2(V1.size()), S(natMergeSort::subVector<T, I>::runCapacity(V1.size())), P(S.size()), range(V1, V2, S, P, 0, V1.size()-1) {}
+    };
+    virtual bool start(){
+        using namespace natMergeSort;
+        runHooks<T, subVector<T, I>> hooks;
+        hooks.statistics = [](const subVector<T, I>&){
+            return " runs="+std::to_string(runsFound);
+        };
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
     }
 };
 
-template <class T>
+template <class T, class I = sortIndex>
 struct uMergeSortTest : test{
     std::vector<int> thresholds;
     int _alpha{1}, _beta{1};
+    bool _adaptive{false};
 
     uMergeSortTest(){
         testName = algorithm::umergesort; 
@@ -244,10 +639,14 @@ struct uMergeSortTest : test{
             thresholds.push_back(read<int>(s, i));
     }
     virtual void parseData(std::string s, int i) override  {
-        parseDataT<T>(s, i);
+        parseDataT<typename inputOf<T>::type>(s, i);
     }
     virtual bool parseSpecificParameters(std::string s) override {
         int i{6};
+        if( preMatch("ratio=auto", s) ){
+            _adaptive = true;
+            return true;
+        }
         if( preMatch("ratio=", s) ){
             _alpha = read<int>(s, i);
             if( i<s.size() )
@@ -257,103 +656,348 @@ struct uMergeSortTest : test{
         }
         return false;
     }
+    struct buffers{
+        dataVector<T> V1, V2;
+        unbMergeSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), V2(V1.size()), range(V1, V2, 0, V1.size()-1) {}
+    };
     virtual bool start(){
-        std::ofstream resultF;
-        std::ofstream reportF;
-        prepare( resultF, reportF );
-
         using namespace unbMergeSort;
         alpha=_alpha;
         beta=_beta;
-        for( auto &filename: inputFiles ){
-            std::vector<T> V;
-            
-            {
-                std::ifstream file;
-                file.open(filename);
-                for( T v; file >> v; V.emplace_back(v) );
-                file.close();
-            }
+        adaptiveRatio=_adaptive;
+        runHooks<T, subVector<T, I>> hooks;
+        hooks.leafBatch = baseBatch<T, I>;
+        hooks.before = resetRates;
+        hooks.statistics = [](const subVector<T, I>&){
+            return adaptiveRatio ? ratioStatistics() : "";
+        };
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
+    }
+};
 
-            if( thresholds.empty() )
-                thresholds.emplace_back(subVector<T>::threshold);
-            for( auto &threshold: thresholds ){
-                for( auto &nThreads: threads ){
-                    std::vector<T> V1(V), V2(V1.size());
-                    subVector<T> fullRange(V1, V2, 0, V1.size()-1);
-                    fullRange.threshold = threshold;
-                    divImp::divImp<subVector<T>, subVector<T>> unbmergesort(divide<T>, impera<T>, base<T>, isBase<T>);
-                    
-                    newResultFile(resultF, filename, nThreads, threshold);
-                    
-                    if( result ){
-                        for( auto &o: unbmergesort.start(fullRange, nThreads, logMe, chronometer).V )
-                            resultF << o << ' ';
-                        resultF.flush();
-                    } else 
-                        unbmergesort.start(fullRange, nThreads, logMe, chronometer);
+template <class T, class I = sortIndex>
+struct quickSortTest : test{
+    std::vector<int> thresholds;
+    I rank{-1};                                 /* k of select and partialsort, -1: n/2  */
 
-                    printReport( reportF, std::to_string(nThreads), std::to_string(V.size()), std::to_string(threshold), 
-                        chronometer?std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(unbmergesort.getDuration()).count()):"", "");
-                }
-            }
+    quickSortTest(const algorithm& name = algorithm::quicksort){
+         testName = name;
+    }
+
+    /* the ranks put in place, and the time of the same by the STL */
+    void setRanks(const I& n){
+        const I k{rank<0 ? n/2 : std::min(rank, testName==algorithm::select ? n-1 : n)};
+        quickSort::subVector<T, I>::lowRank = testName==algorithm::select ? k : 0;
+        quickSort::subVector<T, I>::highRank = testName==algorithm::select ? k : (testName==algorithm::partialsort ? k-1 : std::numeric_limits<I>::max());
+    }
+    std::string stdStatistics(const std::vector<T>& V){
+        if( testName==algorithm::quicksort || !chronometer || V.empty() )
+            return "";
+        std::vector<T> C(V);
+        const I k{std::min<I>(quickSort::subVector<T, I>::lowRank, C.size()-1)}, m{quickSort::subVector<T, I>::highRank+1};
+        const auto begin(std::chrono::steady_clock::now());
+        if( testName==algorithm::select )
+            std::nth_element(C.begin(), C.begin()+k, C.end());
+        else
+            std::partial_sort(C.begin(), C.begin()+m, C.end());
+        return " stdUs="+std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-begin).count());
+    }
+    virtual bool parseSpecificParameters(std::string s) override {
+        if( preMatch("k=", s) && testName!=algorithm::quicksort ){
+            rank = std::max(0ll, std::stoll(s.substr(2)));
+            return true;
         }
-        if( reportF.is_open() )
-            reportF.flush();
+        if( preMatch("partition=", s) ){
+            quickSort::subVector<T, I>::partitionSize = std::stoi(s.substr(10));
+            return true;
+        }
+        if( s=="branchy" ){
+            quickSort::subVector<T, I>::branchless = false;
+            return true;
+        }
+        if( preMatch("pivot=", s) ){
+            std::string rule(s.substr(6));
+            if( rule=="last" )
+                quickSort::subVector<T, I>::pivot = quickSort::pivotRule::last;
+            else if( rule=="median3" )
+                quickSort::subVector<T, I>::pivot = quickSort::pivotRule::median3;
+            else if( rule=="ninther" )
+                quickSort::subVector<T, I>::pivot = quickSort::pivotRule::ninther;
+            else if( rule=="sample" )
+                quickSort::subVector<T, I>::pivot = quickSort::pivotRule::sample;
+            else
+                return false;
+            return true;
+        }
+        return false;
+    }
+    virtual void parseThreshold(std::string s, int i) override {
+        if( readList<int>(thresholds, s, i)==i )
+            thresholds.push_back(read<int>(s, i));
+    }
+    virtual void parseData(std::string s, int i) override {
+        parseDataT<typename inputOf<T>::type>(s, i);
+    }
+    /* in place: no scratch */
+    struct buffers{
+        dataVector<T> V1;
+        quickSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), range(V1, 0, V1.size()-1) {}
+    };
+    virtual bool start(){
+        using namespace quickSort;
+        runHooks<T, subVector<T, I>> hooks;
+        hooks.input = [this, &hooks](const std::vector<T>& V){
+            setRanks(V.size());
+            hooks.low = subVector<T, I>::lowRank;
+            hooks.high = subVector<T, I>::highRank;
+            return stdStatistics(V);
+        };
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
+    }
+};
 
-        return true;
+template <class T, class I = sortIndex>
+struct sampleSortTest : test{
+    std::vector<int> thresholds;
+
+    sampleSortTest(){
+         testName = algorithm::samplesort;
+    }
+    virtual bool parseSpecificParameters(std::string s) override {
+        if( preMatch("buckets=", s) ){
+            const int k{std::stoi(s.substr(8))};
+            if( k<2 || k>128 || (k&(k-1))!=0 )
+                return false;
+            sampleSort::subVector<T, I>::buckets = k;
+            return true;
+        }
+        if( preMatch("oversampling=", s) ){
+            sampleSort::subVector<T, I>::oversampling = std::max(1, std::stoi(s.substr(13)));
+            return true;
+        }
+        if( preMatch("classify=", s) ){
+            sampleSort::subVector<T, I>::classifySize = std::stoi(s.substr(9));
+            return true;
+        }
+        return false;
+    }
+    virtual void parseThreshold(std::string s, int i) override {
+        if( readList<int>(thresholds, s, i)==i )
+            thresholds.push_back(read<int>(s, i));
+    }
+    virtual void parseData(std::string s, int i) override {
+        parseDataT<typename inputOf<T>::type>(s, i);
+    }
+    struct buffers{
+        dataVector<T> V1, V2;
+        sampleSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), V2(V1.size()), range(V1, V2, 0, V1.size()-1) {}
+    };
+    virtual bool start(){
+        using namespace sampleSort;
+        runHooks<T, subVector<T, I>> hooks;
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
     }
 };
 
-template <class T>
-struct quickSortTest : test{
+template <class T, class I = sortIndex>
+struct radixSortTest : test{
     std::vector<int> thresholds;
 
-    quickSortTest(){
-         testName = algorithm::quicksort;
+    radixSortTest(){
+         testName = algorithm::radixsort;
+    }
+    virtual bool parseSpecificParameters(std::string s) override {
+        if( preMatch("lsd=", s) ){
+            radixSort::subVector<T, I>::lsdSize = std::stoi(s.substr(4));
+            return true;
+        }
+        if( preMatch("classify=", s) ){
+            radixSort::subVector<T, I>::classifySize = std::stoi(s.substr(9));
+            return true;
+        }
+        return false;
+    }
+    virtual void parseThreshold(std::string s, int i) override {
+        if( readList<int>(thresholds, s, i)==i )
+            thresholds.push_back(read<int>(s, i));
+    }
+    virtual void parseData(std::string s, int i) override {
+        parseDataT<typename inputOf<T>::type>(s, i);
+    }
+    struct buffers{
+        dataVector<T> V1, V2;
+        radixSort::subVector<T, I> range;
+        buffers(const std::vector<T>& V) : V1(V.begin(), V.end()), V2(V1.size()), range(V1, V2, 0, V1.size()-1) {}
+    };
+    virtual bool start(){
+        using namespace radixSort;
+        runHooks<T, subVector<T, I>> hooks;
+        return runSorts<buffers>(thresholds, subVector<T, I>::threshold, [](){
+            return divImp::divImp<subVector<T, I>, subVector<T, I>>(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+        }, hooks);
+    }
+};
+
+template <class T, class I = sortIndex>
+struct extSortTest : test{
+    std::vector<int> thresholds;
+
+    extSortTest() {
+        testName = algorithm::extsort;
+    }
+    /* the input is hashed as read again, through mmap if binary or    */
+    /* generated again, and the output checked by blocks as read from  */
+    /* the sorted file                                                 */
+    std::string verifyFiles(const std::string& filename, const int& out, const std::size_t& n){
+        inputHash = multisetHash();
+        if( isGeneratedInput(filename) ){
+            std::vector<T> V;
+            generateInput(filename, seed, V);
+            inputHash = hashMultiset(V.data(), V.size());
+        } else if( isBinaryFile(filename) ){
+            mappedData<T> data(filename);
+            inputHash = hashMultiset(data.data(), data.size());
+        } else {
+            std::ifstream file(filename);
+            std::vector<T> C;
+            while( extSort::readChunk(file, C, extSort::blockSize<<6) )
+                inputHash += hashMultiset(C.data(), C.size());
+        }
+        multisetHash outputHash;
+        std::size_t misplaced{n};
+        std::vector<T> block((extSort::blockSize<<6)+1);    /* the last of the previous block first */
+        for( std::size_t o=0; o<n; ){
+            const std::size_t m{std::min(block.size()-1, n-o)};
+            extSort::readAt(out, block.data()+1, m, o);
+            outputHash += hashMultiset(block.data()+1, m);
+            if( misplaced==n ){
+                const std::size_t x{o>0 ? firstMisplaced(block.data(), m+1) : firstMisplaced(block.data()+1, m)+1};
+                if( x<=m )
+                    misplaced = o+x-1;
+            }
+            block[0] = block[m];
+            o += m;
+        }
+        return verifyOutcome(misplaced, n, outputHash);
+    }
+    virtual bool parseSpecificParameters(std::string s) override {
+        if( preMatch("chunk=", s) ){
+            extSort::chunkSize = std::max(0l, std::stol(s.substr(6)));
+            return true;
+        }
+        if( preMatch("spill=", s) ){
+            extSort::spillDir = s.substr(6);
+            return true;
+        }
+        return false;
     }
     virtual void parseThreshold(std::string s, int i) override {
         if( readList<int>(thresholds, s, i)==i )
             thresholds.push_back(read<int>(s, i));
     }
     virtual void parseData(std::string s, int i) override {
-        parseDataT<T>(s, i);
+        parseDataT<typename inputOf<T>::type>(s, i);
     }
     virtual bool start(){
         std::ofstream resultF;
         std::ofstream reportF;
         prepare( resultF, reportF );
 
-        using namespace quickSort;
+        using namespace mergeSort;
+        if( processes ){
+            std::cout << "Warning: processes is not available for extsort, going on with threads!" << std::endl;
+            shareBuffers.store(false, std::memory_order_relaxed);
+        }
+        if( !tenants.empty() ){
+            std::cout << "Warning: tenants is not available for extsort!" << std::endl;
+            tenants.clear();
+        }
         for( auto &filename: inputFiles ){
-            std::vector<T> V;
-            
-            {
-                std::ifstream file;
-                file.open(filename);
-                for( T v; file >> v; V.emplace_back(v) );
-                file.close();
-            }
             if( thresholds.empty() )
-                thresholds.emplace_back(subVector<T>::threshold);
+                thresholds.emplace_back(subVector<T, I>::threshold);
             for( auto &threshold: thresholds ){
                 for( auto &nThreads: threads ){
-                    std::vector<T> V1(V);
-                    subVector<T> fullRange(V1, 0, V1.size()-1);
-                    fullRange.threshold = threshold;
-                    divImp::divImp<subVector<T>, subVector<T>> quicksort(divide<T>, impera<T>, base<T>, isBase<T>);
-                    
+                    /* the chunks are sorted by mergesort in V1 and V2  */
+                    dataVector<T> V1, V2;
+                    std::string statistics;
+                    auto sortChunk = [&](const std::vector<T>& C) -> const T* {
+                        V1.assign(C.begin(), C.end());
+                        V2.resize(V1.size());
+                        subVector<T, I> fullRange(0, V1, V2, 0, V1.size()-1);
+                        fullRange.threshold = threshold;
+                        divImp::divImp<subVector<T, I>, subVector<T, I>> mergesort(divide<T, I>, impera<T, I>, base<T, I>, isBase<T, I>);
+                        mergesort.setLazy(lazy);
+                        mergesort.setLocality(locality);
+                        mergesort.setOfferCost(offerCost);
+                        mergesort.setLeafBatching(batch, baseBatch<T, I>);
+                        const T *sorted(mergesort.start(fullRange, nThreads, logMe).V.data());
+                        statistics = mergesort.getStatistics();
+                        return sorted;
+                    };
+
                     newResultFile(resultF, filename, nThreads, threshold);
-                    
+
+                    /* a generated input is all in memory, a binary one mapped */
+                    std::ifstream file;
+                    std::unique_ptr<mappedData<T>> data;
+                    std::vector<T> generated;
+                    const T *source(nullptr);
+                    std::size_t read{0}, sourceSize{0};
+                    if( isGeneratedInput(filename) ){
+                        generateInput(filename, seed, generated);
+                        source = generated.data();
+                        sourceSize = generated.size();
+                    } else if( isBinaryFile(filename) ){
+                        data.reset(new mappedData<T>(filename));
+                        source = data->data();
+                        sourceSize = data->size();
+                    } else
+                        file.open(filename);
+                    auto readChunk = [&](std::vector<T>& C, const std::size_t& m) -> bool {
+                        if( !source )
+                            return extSort::readChunk(file, C, m);
+                        C.assign(source+read, source+std::min(sourceSize, read+m));
+                        read += C.size();
+                        return !C.empty();
+                    };
+                    int out{-1};
+                    std::size_t n{0};
+                    beginRun();
+                    const auto begin(std::chrono::steady_clock::now());
+                    const std::string runStatistics(extSort::sortFile<T>(readChunk, sortChunk, nThreads, out, n));
+                    const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-begin);
+                    endRun();
                     if( result ){
-                        for( auto &o: quicksort.start(fullRange, nThreads, logMe, chronometer).V )
-                            resultF << o << ' ';
+                        const bool binary{isBinaryFile(resultFile.back())};
+                        std::vector<T> block(extSort::blockSize);
+                        if( binary )
+                            writeDataHeader<T>(resultF, n);
+                        for( std::size_t o=0; o<n; o+=block.size() ){
+                            const std::size_t m{std::min(block.size(), n-o)};
+                            extSort::readAt(out, block.data(), m, o);
+                            if( binary )
+                                resultF.write(reinterpret_cast<const char*>(block.data()), m*sizeof(T));
+                            else
+                                for( std::size_t k=0; k<m; ++k )
+                                    resultF << block[k] << ' ';
+                        }
                         resultF.flush();
-                    } else 
-                        quicksort.start(fullRange, nThreads, logMe, chronometer);
+                    }
+                    const std::string verified(verify ? verifyFiles(filename, out, n) : "");
+                    close(out);
 
-                    printReport( reportF, std::to_string(nThreads), std::to_string(V.size()), std::to_string(threshold), 
-                        chronometer?std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(quicksort.getDuration()).count()):"", "");
+                    reportRow row(runReport(nThreads, n, threshold, duration));
+                    row.statistics = runStatistics+" lastChunk: "+statistics+verified;
+                    printReport(reportF, row);
                 }
             }
         }
@@ -364,7 +1008,7 @@ struct quickSortTest : test{
     }
 };
 
-template <class T>
+template <class T, class I = sortIndex>
 struct pMergeSortTest : test{
     std::vector<std::vector<int>> thresholds;
 
@@ -395,7 +1039,7 @@ struct pMergeSortTest : test{
         }
     }
     virtual void parseData(std::string s, int i) override {
-        parseDataT<T>(s, i);
+        parseDataT<typename inputOf<T>::type>(s, i);
     }
     virtual bool start(){
         std::ofstream resultF;
@@ -403,47 +1047,61 @@ struct pMergeSortTest : test{
         prepare( resultF, reportF );
 
         using namespace pMergeSort;
+        if( processes ){
+            std::cout << "Warning: processes is not available for pmergesort, going on with threads!" << std::endl;
+            shareBuffers.store(false, std::memory_order_relaxed);
+        }
+        if( lazy )
+            std::cout << "Warning: lazy is not available for pmergesort!" << std::endl;
+        if( batch )
+            std::cout << "Warning: batch is not available for pmergesort!" << std::endl;
+        if( !tenants.empty() ){
+            std::cout << "Warning: tenants is not available for pmergesort!" << std::endl;
+            tenants.clear();
+        }
         for( auto &filename: inputFiles ){
             std::vector<T> V;
             
-            {
-                std::ifstream file;
-                file.open(filename);
-                for( T v; file >> v; V.emplace_back(v) );
-                file.close();
-            }
+            readInput(filename, V);
+            hashInput(V);
 
             if( thresholds.empty() )
-                thresholds.emplace_back(1, subVector<T>::threshold);
+                thresholds.emplace_back(1, subVector<T, I>::threshold);
             for( auto &threshold: thresholds ){
                 for( auto &nThreads: threads ){
-                    std::vector<T> V1(V), V2(V1.size());
-                    subVector<T> fullRange(0, V1, V2, 0, V1.size()-1);
+                    dataVector<T> V1(V.begin(), V.end()), V2(V1.size());
+                    subVector<T, I> fullRange(0, V1, V2, 0, V1.size()-1);
                     if( threshold.size()>0 ){
                         fullRange.threshold = threshold[0];
                         if( threshold.size()>1 ){
-                            subVectors<T>::threshold = threshold[1];
+                            mergeSlice<T, I>::threshold = std::max(1, threshold[1]);
                             if( threshold.size()>2 )
-                                subVectors1<T>::threshold = threshold[2];
+                                std::cout << "Warning: the third threshold of pmergesort is not used anymore!" << std::endl;
                         }
                     }
 
 
-                    auto *parJob = new genericJob<subVector<T>, subVector<T>>(pMergeSortRoutine<T>, std::vector<job*>(), fullRange);
+                    auto *parJob = new genericJob<subVector<T, I>, subVector<T, I>>(pMergeSortRoutine<T, I>, std::vector<job*>(), fullRange);
 
-                    setTest<subVector<T>, subVector<T>> pmergesort(mergeSortRoutine<T>, parJob);
+                    setTest<subVector<T, I>, subVector<T, I>> pmergesort(mergeSortRoutine<T, I>, parJob);
+                    pmergesort.setLocality(locality);
+                    pmergesort.setOfferCost(offerCost);
                     
                     newResultFile(resultF, filename, nThreads, threshold);
                     
+                    beginRun();
+                    resetSliceStatistics();
+                    timeSlices = (reportSpec & reportable::statistics) != reportable::null;
+                    const subVector<T, I> sorted(pmergesort.start(fullRange, nThreads, logMe, chronometer));
+                    endRun();
                     if( result ){
-                        for( auto &o: *(pmergesort.start(fullRange, nThreads, logMe, chronometer).V) )
-                            resultF << o << ' ';
+                        writeResult(resultF, *sorted.V);
                         resultF.flush();
-                    } else 
-                        pmergesort.start(fullRange, nThreads, logMe, chronometer);
+                    }
 
-                    printReport( reportF, std::to_string(nThreads), std::to_string(V.size()), std::to_string(threshold), 
-                        chronometer?std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(pmergesort.getDuration()).count()):"", "");
+                    reportRow row(runReport(nThreads, V.size(), threshold, pmergesort.getDuration()));
+                    row.statistics = pmergesort.getStatistics()+sliceStatistics()+verifyRun(sorted.V->data()+sorted.i, sorted.j-sorted.i+1)+permuteStatistics(sorted.V->data()+sorted.i, sorted.j-sorted.i+1);
+                    printReport(reportF, row);
                 }
             }
         }
@@ -467,7 +1125,36 @@ bool match(std::string s, char argv[]){
     return false;
 }
 
-/* TODO: choose type, i.e. here it is int by default    */
+/* the test on ints, with 32 bit indices for index32 */
+template <template <class, class> class X, class... A>
+test* newTest(const bool& index32, A... a){
+    if( index32 )
+        return new X<int, int>(a...);
+    return new X<int, sortIndex>(a...);
+}
+
+/* the test on records of bytes bytes, if any, or on their (key, index) */
+/* pairs, when indirect or of a size without its record type            */
+template <template <class, class> class X, class... A>
+test* newRecordTest(const bool& index32, const int& bytes, const bool& indirect, A... a){
+    if( bytes==0 && !indirect )
+        return newTest<X>(index32, a...);
+    if( !indirect )
+        switch( bytes ){
+        case 16:
+            return new X<record<16>, sortIndex>(a...);
+        case 64:
+            return new X<record<64>, sortIndex>(a...);
+        case 100:
+            return new X<record<100>, sortIndex>(a...);
+        case 256:
+            return new X<record<256>, sortIndex>(a...);
+        default:
+            std::cout << "Warning: records of " << bytes << " bytes are sorted only indirectly!" << std::endl;
+        }
+    return new X<keyIndex, sortIndex>(a...);
+}
+
 test* parser(int argc, char *argv[]){
     if( argc<2 ){
         printHelp(argv);
@@ -476,40 +1163,46 @@ test* parser(int argc, char *argv[]){
 
     test* myTest;
 
-    switch(argv[1][0]){
-    case 'm':
-    {
-        auto *newTest = new mergeSortTest<int>();
-        myTest = newTest; 
-        break;
-    }
-    case 'u':
-    {
-        auto *newTest = new uMergeSortTest<int>();
-        myTest = newTest;
-        break;
-    }
-    case 'q':
-    {
-        auto *newTest = new quickSortTest<int>();
-        myTest = newTest;
-        break;
-    }
-    case 'p':
-    {
-        auto *newTest = new pMergeSortTest<int>();
-        myTest = newTest;
-        break;
-    }
-    case 'i':
-    {
-        printAdditionalHelp();
-        return nullptr;
-    }
-    default:
+    /* the index and the element types are fixed with the test   */
+    bool index32{false}, indirect{false};
+    int bytes{0};
+    for( int i=2; i<argc; ++i )
+        if( preMatch("index=", argv[i]) )
+            index32 = std::string(&argv[i][6])=="32";
+        else if( preMatch("record=", argv[i]) )
+            bytes = std::max(8, std::stoi(&argv[i][7]));
+        else if( match("indirect", argv[i]) )
+            indirect = true;
+
+    /* whole names: tests may share the initial  */
+    if( match("mergesort", argv[1]) )
+        myTest = newRecordTest<mergeSortTest>(index32, bytes, indirect);
+    else if( match("umergesort", argv[1]) )
+        myTest = newRecordTest<uMergeSortTest>(index32, bytes, indirect);
+    else if( match("quicksort", argv[1]) )
+        myTest = newRecordTest<quickSortTest>(index32, bytes, indirect);
+    else if( match("select", argv[1]) )
+        myTest = newRecordTest<quickSortTest>(index32, bytes, indirect, test::algorithm::select);
+    else if( match("partialsort", argv[1]) )
+        myTest = newRecordTest<quickSortTest>(index32, bytes, indirect, test::algorithm::partialsort);
+    else if( match("pmergesort", argv[1]) )
+        myTest = newRecordTest<pMergeSortTest>(index32, bytes, indirect);
+    else if( match("samplesort", argv[1]) )
+        myTest = newTest<sampleSortTest>(index32);
+    else if( match("radixsort", argv[1]) )
+        myTest = newTest<radixSortTest>(index32);
+    else if( match("kmergesort", argv[1]) )
+        myTest = newRecordTest<kMergeSortTest>(index32, bytes, indirect);
+    else if( match("extsort", argv[1]) )
+        myTest = newTest<extSortTest>(index32);
+    else if( match("nmergesort", argv[1]) )
+        myTest = newRecordTest<nMergeSortTest>(index32, bytes, indirect);
+    else {
         printAdditionalHelp();
         return nullptr;
     }
+    if( (bytes>0 || indirect) && (match("samplesort", argv[1]) || match("radixsort", argv[1]) || match("extsort", argv[1])) )
+        std::cout << "Warning: records are not available for " << argv[1] << ", going on with ints!" << std::endl;
 
     for( int i=2; i<argc; ++i ){
         if( preMatch("threads=", argv[i]) ){
@@ -517,10 +1210,33 @@ test* parser(int argc, char *argv[]){
                 myTest->threads.push_back( std::stoi(std::string(&argv[i][8])) );
             else 
                 readList(myTest->threads, argv[i], 8);
+        } else if( preMatch("tenants=", argv[i]) ){
+            if( argv[i][8]>='0' && argv[i][8]<='9' )
+                myTest->tenants.push_back( std::stoi(std::string(&argv[i][8])) );
+            else 
+                readList(myTest->tenants, argv[i], 8);
+        } else if( preMatch("pool.size=", argv[i]) ){
+            workerPool::get().resize(std::stoi(&argv[i][10]));
+        } else if( preMatch("block=", argv[i]) ){
+            sortBlock = std::min(64, std::stoi(&argv[i][6]));
+        } else if( preMatch("simd=", argv[i]) ){
+            std::string level(&argv[i][5]);
+            simdLevel wanted{level=="avx512" ? simdLevel::avx512 : level=="avx2" ? simdLevel::avx2 : simdLevel::scalar};
+            if( wanted>cpuSimdLevel() )
+                std::cout << "Warning: simd=" << level << " is not supported by this cpu!" << std::endl;
+            else
+                sortSimd = wanted;
+        } else if( preMatch("index=", argv[i]) ){
+            if( std::string(&argv[i][6])!="32" && std::string(&argv[i][6])!="64" )
+                std::cout << "what about " << argv[i] << "?!?!?!?!?!?!?!?!?" << std::endl;
         } else if( preMatch("threshold=", argv[i]) ){
             myTest->parseThreshold(argv[i], 10);
         } else if( preMatch("input=", argv[i]) ){
+            myTest->binaryInput = false;
             myTest->parseData(argv[i], 6);
+        } else if( preMatch("input.bin=", argv[i]) ){
+            myTest->binaryInput = true;
+            myTest->parseData(argv[i], 10);
         } else if( preMatch("log=", argv[i] ) ){
             if( myTest->logFile.empty() )
                 myTest->logFile = "test.log";
@@ -552,10 +1268,27 @@ test* parser(int argc, char *argv[]){
             }
         } else if( preMatch("log.dim=", argv[i]) ){
             myTest->logSize = std::stoi(&argv[i][8]);
+        } else if( preMatch("offer.cost=", argv[i]) ){
+            myTest->offerCost = std::stoull(&argv[i][11]);
         } else if( preMatch("log.file=", argv[i]) ){
             myTest->logFile = std::string( &argv[i][9] );
         } else if( match("chrono", argv[i]) ){
             myTest->chronometer = true;
+        } else if( match("lazy", argv[i]) ){
+            myTest->lazy = true;
+        } else if( match("batch", argv[i]) ){
+            myTest->batch = true;
+        } else if( match("verify", argv[i]) ){
+            myTest->verify = true;
+        } else if( preMatch("record=", argv[i]) ){
+            myTest->recordBytes = std::max(8, std::stoi(&argv[i][7]));
+        } else if( match("indirect", argv[i]) ){
+        } else if( preMatch("seed=", argv[i]) ){
+            myTest->seed = std::stoull(&argv[i][5]);
+        } else if( match("locality", argv[i]) ){
+            myTest->locality = true;
+        } else if( match("processes", argv[i]) ){
+            myTest->processes = true;
         } else if( match("result", argv[i]) ){
             myTest->result = true;
         } else if( preMatch("result.file=", argv[i]) ){
@@ -579,7 +1312,32 @@ test* parser(int argc, char *argv[]){
                 } else if( preMatch("parameters", &argv[i][j]) ){
                     myTest->reportSpec = test::reportable(uint32_t(test::reportable::parameters) | uint32_t(myTest->reportSpec));
                     j+=11;
-                }
+                } else if( preMatch("statistics", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::statistics) | uint32_t(myTest->reportSpec));
+                    j+=11;
+                } else if( preMatch("cacheMisses", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::cacheMisses) | uint32_t(myTest->reportSpec));
+                    j+=12;
+                } else if( preMatch("speedup", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::speedup) | uint32_t(myTest->reportSpec));
+                    j+=8;
+                } else if( preMatch("branchMisses", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::branchMisses) | uint32_t(myTest->reportSpec));
+                    j+=13;
+                } else if( preMatch("nsPerElement", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::nsPerElement) | uint32_t(myTest->reportSpec));
+                    j+=13;
+                } else if( preMatch("mergeThroughput", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::mergeThroughput) | uint32_t(myTest->reportSpec));
+                    j+=16;
+                } else if( preMatch("bytesMoved", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::bytesMoved) | uint32_t(myTest->reportSpec));
+                    j+=11;
+                } else if( preMatch("peakMemory", &argv[i][j]) ){
+                    myTest->reportSpec = test::reportable(uint32_t(test::reportable::peakMemory) | uint32_t(myTest->reportSpec));
+                    j+=11;
+                } else
+                    ++j;
             }
             if( myTest->reportFile.empty() )
                 myTest->reportFile = myTest->getTestName();
@@ -600,11 +1358,29 @@ test* parser(int argc, char *argv[]){
 void printHelp(char *argv[]){
     std::cout << "                 \033[41m \033[43m \033[42m \033[44m\033[1;36m DEI: TESTER - (c) Michele Miccinesi 2018 - \033[44m \033[42m \033[43m \033[41m \033[0m\n";
     std::cout << "\033[1;36;44mUSAGE:\033[0m\n\033[41m \033[0m\n\033[41m \033[0m " <<   argv[0] << " \033[1mtest_name option1 option2\033[0m ...\n" << "\033[41m \033[43m        \033[0m where \033[1moption\033[0m is in \033[1moptions\033[0m or \033[1moptions(test_name)\033[0m:\n";
-    std::cout << "\033[41m \033[0m\n\033[41m \033[0m \033[1mtest_name\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mmergesort\033[0m | \033[1mumergesort\033[0m | \033[1mpmergesort\033[0m | \033[1mquicksort\033[0m\n" <<
+    std::cout << "\033[41m \033[0m\n\033[41m \033[0m \033[1mtest_name\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mmergesort\033[0m | \033[1mumergesort\033[0m | \033[1mpmergesort\033[0m | \033[1mquicksort\033[0m | \033[1msamplesort\033[0m | \033[1mradixsort\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m | \033[1mkmergesort\033[0m | \033[1mextsort\033[0m | \033[1mnmergesort\033[0m | \033[1mselect\033[0m | \033[1mpartialsort\033[0m\n" <<
         "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mthreads\033[0m=\033[33mint\033[0m | \033[1mthreads\033[0m=[\033[33mints\033[0m] \n" <<
         "\033[41m \033[43m        \033[0m \033[1mthreshold\033[0m=\033[32mvalue\033[0m | \033[1mthreshold\033[0m=[\033[32mvalues\033[0m]\n" << 
         "\033[41m \033[43m        \033[0m \033[1minput\033[0m=\033[33mint\033[0m | \033[1minput\033[0m=[\033[33mints\033[0m] | \033[1minput\033[0m=\033[31minput_filename\033[0m | \033[1minput\033[0m=[\033[31minput_filenames\033[0m]\n" <<
+        "\033[41m \033[43m        \033[0m \033[1minput.bin\033[0m=\033[33mint\033[0m | \033[1minput.bin\033[0m=[\033[33mints\033[0m]\n" <<
+        "\033[41m \033[43m        \033[0m \033[1minput\033[0m=\033[35mdistribution\033[0m:\033[33msize\033[0m | \033[1minput\033[0m=\033[35mdistribution\033[0m:\033[33mparameter\033[0m:\033[33msize\033[0m | \033[1minput\033[0m=[\033[35mspecs\033[0m]" <<
+        "\n\033[41m \033[43m        \033[42m        \033[0m where \033[35mdistribution\033[0m ::= \033[1muniform\033[0m | \033[1msorted\033[0m | \033[1mreverse\033[0m | \033[1mfew\033[0m | \033[1mzipf\033[0m | \033[1morgan\033[0m | \033[1mgauss\033[0m | \033[1malmost\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mseed\033[0m=\033[33mint\033[0m\n" <<
         "\033[41m \033[43m        \033[0m \033[1mchrono \n" << 
+        "\033[41m \033[43m        \033[0m \033[1mverify \n" << 
+        "\033[41m \033[43m        \033[0m \033[1mprocesses \n" << 
+        "\033[41m \033[43m        \033[0m \033[1mlazy \n" << 
+        "\033[41m \033[43m        \033[0m \033[1mlocality \n" << 
+        "\033[41m \033[43m        \033[0m \033[1mbatch \n" << 
+        "\033[41m \033[43m        \033[0m \033[1moffer.cost\033[0m=\033[33mint\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mtenants\033[0m=\033[33mint\033[0m | \033[1mtenants\033[0m=[\033[33mints\033[0m]\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mpool.size\033[0m=\033[33mint\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mblock\033[0m=\033[33mint\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1msimd\033[0m=\033[1mscalar\033[0m | \033[1msimd\033[0m=\033[1mavx2\033[0m | \033[1msimd\033[0m=\033[1mavx512\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mindex\033[0m=\033[1m32\033[0m | \033[1mindex\033[0m=\033[1m64\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mrecord\033[0m=\033[33mint\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mindirect \n" << 
         "\033[41m \033[43m        \033[0m \033[1mresult\033[0m \n" <<
         "\033[41m \033[43m        \033[0m \033[1mresult.file\033[0m=\033[31mresult_filename\033[0m \n" <<
         "\033[41m \033[43m        \033[0m \033[1mlog\033[0m=[\033[36mloggables\033[0m]" <<
@@ -616,8 +1392,19 @@ void printHelp(char *argv[]){
         "\033[41m \033[43m        \033[0m \033[1mlog.dim\033[0m=\033[33mint\033[0m\n" << 
         "\033[41m \033[43m        \033[0m \033[1mreport\033[0m=[\033[34mreportables\033[0m]" <<
         "\n\033[41m \033[43m        \033[42m        \033[0m where \033[34mreportable\033[0m ::= \033[1mthreads\033[0m | \033[1msize\033[0m | \033[1mthreshold\033[0m | \033[1mchrono\033[0m | \033[1mparameters\033[0m\n" <<
+        "\033[41m \033[43m        \033[42m        \033[0m                   | \033[1mstatistics\033[0m | \033[1mcacheMisses\033[0m | \033[1mspeedup\033[0m\n" <<
+        "\033[41m \033[43m        \033[42m        \033[0m                   | \033[1mbranchMisses\033[0m | \033[1mnsPerElement\033[0m | \033[1mmergeThroughput\033[0m\n" <<
+        "\033[41m \033[43m        \033[42m        \033[0m                   | \033[1mbytesMoved\033[0m | \033[1mpeakMemory\033[0m\n" <<
         "\033[41m \033[43m        \033[0m \033[1mreport.file\033[0m=\033[31mreport_filename\033[0m\n" <<
-        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(umergesort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mratio\033[0m=\033[33mint\033[0m:\033[33mint\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(mergesort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mhalf\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(umergesort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mratio\033[0m=\033[33mint\033[0m:\033[33mint\033[0m | \033[1mratio\033[0m=\033[1mauto\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(kmergesort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mways\033[0m=\033[33mint\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(extsort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mchunk\033[0m=\033[33mint\033[0m | \033[1mspill\033[0m=\033[31mdirectory\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(quicksort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mpartition\033[0m=\033[33mint\033[0m | \033[1mbranchy\033[0m\n" <<
+        "\033[41m \033[43m        \033[0m \033[1mpivot\033[0m=\033[1mlast\033[0m | \033[1mpivot\033[0m=\033[1mmedian3\033[0m | \033[1mpivot\033[0m=\033[1mninther\033[0m | \033[1mpivot\033[0m=\033[1msample\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(select)\033[0m, \033[1moptions(partialsort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mk\033[0m=\033[33mint\033[0m | \033[1moptions(quicksort)\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(samplesort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mbuckets\033[0m=\033[33mint\033[0m | \033[1moversampling\033[0m=\033[33mint\033[0m | \033[1mclassify\033[0m=\033[33mint\033[0m\n" <<
+        "\033[41m \033[0m\n\033[41m \033[0m \033[1moptions(radixsort)\033[0m ::=\n\033[41m \033[43m        \033[0m \033[1mlsd\033[0m=\033[33mint\033[0m | \033[1mclassify\033[0m=\033[33mint\033[0m\n" <<
         "\033[41m \033[0m\n\033[41m \033[0m \033[1m[type]\033[0m ::= \n\033[41m \033[43m        \033[0m \033[1m[t0,t1,t2,t3]\033[0m | \033[1m[t0..t1]\033[0m | \033[1m[t0,t1..t2]\033[0m\n" <<
         "\033[41m \033[43m        \033[0m in which with   \033[1m,\033[0m   you specify a list of values, while \n" <<
         "\033[41m \033[43m        \033[0m with   \033[1m..\033[0m   you specify a range, and when the separators are mixed\n" <<
@@ -638,25 +1425,84 @@ void printAdditionalHelp(){
     
     "\033[1mmergesort\033[0m :: classical recursive mergesort, division in halves\n" << 
     "    |__ \033[1mthreshold\033[0m :: here is a negative number denoting the depth in the division tree\n" <<
+    "    |__ \033[1mhalf\033[0m :: auxiliary buffer of n/2 elements instead of n: the left half of a range\n" <<
+    "                is copied out and merged back with the right one, so the sorted ranges stay\n" <<
+    "                in the input buffer; one more copy per merge, see peakMemory\n" <<
     "\033[1mumergesort\033[0m :: unbalanced mergesort, division in two parts with a user-defined ratio\n" <<
     "    |__ \033[1mthreshold\033[0m :: here is a positive number denoting the size\n" <<
     "    |__ \033[1mratio\033[0m=int:int :: as explained above\n" <<
+    "    |__ \033[1mratio\033[0m=auto :: the ratio of each parallel division from the recent ns per merged\n" <<
+    "                element of the workers: the dividing worker keeps the left part, larger if it\n" <<
+    "                is faster than the others; int:int (default 1:1) until they are measured;\n" <<
+    "                statistics get adaptiveSplits, leftShare=mean%(min%..max%) and workerNsPerElement\n" <<
     "\033[1mpmergesort\033[0m :: mergesort with parallelised merge\n" <<
-    "    |__ \033[1mthreshold\033[0m :: we have 3 thresholds to define here:\n" <<
+    "    |__ \033[1mthreshold\033[0m :: we have 2 thresholds to define here:\n" <<
     "                1 - the same as for mergesort\n" <<
-    "                2 - the minimum size we want for dividing the merge process\n" <<
-    "                3 - the minimum size we want for dividing the copy process\n" <<
+    "                2 - the output elements of each slice of a parallel merge (default 8192): a merge\n" <<
+    "                    of n elements is split by merge path (co-ranks) in n/t2 slices of equal\n" <<
+    "                    output, whatever the distribution of the keys; merges below 2*t2 are not split\n" <<
     "                If you want, you can specify only the first with \033[1mthreshold=\033[0mt1; otherwise\n" <<
-    "                you can specify them with a list, ex. [t1] or [t1,t2] or [t1,t2,t3];\n" <<
+    "                you can specify them with a list, ex. [t1] or [t1,t2];\n" <<
     "                as usual, if you want to loop over many of them, write down a list of lists,\n" <<
-    "                ex. [[t11,t12,t13],[t21,t22],[t31,t32,t33],[t41]]; range operator  \033[1m..\033[0m  is not\n" <<
+    "                ex. [[t11,t12],[t21,t22],[t31]]; range operator  \033[1m..\033[0m  is not\n" <<
     "                defined and for simplicity all elements of the list must be of the same type,\n" <<
-    "                so if you write [[t11,t12,t13],[t21,t22],[t31,t32,t33],\033[31mt41\033[0m] then t41 will not\n" <<
+    "                so if you write [[t11,t12],[t21,t22],\033[31mt31\033[0m] then t31 will not\n" <<
     "                be recognised\n" <<
-    "                \033[1;31;43mWARNING:\033[0m for performance, there is not the check for corner cases, so\n" <<
-    "                         minimum sizes for dividing merge/copy processes must be reasonably big\n" <<
+    "                slices, and the mean (imbalance) and the worst (worstImbalance) over the merges\n" <<
+    "                of the cpu time of the slowest slice over the mean one, are in the statistics\n" <<
+    "                reportable\n" <<
+    "\033[1mkmergesort\033[0m :: multiway mergesort, division in ways parts merged at once through a loser tree\n" <<
+    "    |__ threshold :: here is a negative number denoting the depth in the division tree (default -3)\n" <<
+    "    |__ \033[1mways\033[0m=int :: parts of a division, up to 64; by default as many as fit in L2 with 16KB each\n" <<
+    "\033[1mnmergesort\033[0m :: natural mergesort: the runs of the input are found (in parallel, decreasing ones\n" <<
+    "              reversed, short ones sorted up to block elements) and merged as in powersort, so\n" <<
+    "              that nearly sorted inputs are sorted in close to linear time; the runs found are\n" <<
+    "              in the statistics reportable\n" <<
+    "    |__ threshold :: here is the size under which the merges go on sequentially (default 16384)\n" <<
+    "\033[1mextsort\033[0m :: external mergesort, for inputs larger than memory: the input file is read in\n" <<
+    "           chunks, each sorted by mergesort with threads workers and spilled as a sorted run\n" <<
+    "           in a temporary file; then the runs are merged in threads parts (split by sampled\n" <<
+    "           splitters) at once, each by a loser tree with read-ahead and write-behind blocks.\n" <<
+    "           Times of the two phases and runs are in the statistics reportable, chrono is\n" <<
+    "           the whole time, I/O included\n" <<
+    "    |__ threshold :: the one of mergesort, for the chunks\n" <<
+    "    |__ \033[1mchunk\033[0m=int :: elements of a chunk; by default an eighth of the physical memory, as\n" <<
+    "                    three chunks are in memory at once (read ahead, sorted, auxiliary)\n" <<
+    "    |__ \033[1mspill\033[0m=directory :: where the temporary files go (default TMPDIR or /tmp); they are\n" <<
+    "                          unlinked at once, so they are removed even if the run is killed\n" <<
     "\033[1mquicksort\033[0m :: classical recursive quicksort, elements equal to pivot are kept together in division\n" <<
     "    |__ \033[1mthreshold\033[0m :: here again is a positive number denoting the size\n" <<
+    "    |__ \033[1mpartition\033[0m=int :: from this size on, the partition is done in parallel by blocks with\n" <<
+    "                     the idle workers of the workgroup (default 65536)\n" <<
+    "    |__ \033[1mbranchy\033[0m :: below partition, the classical three-way loop instead of the branchless\n" <<
+    "                   block partition (BlockQuicksort), for comparison\n" <<
+    "    |__ \033[1mpivot\033[0m=rule :: last (default) element, median3 of first, middle and last, ninther\n" <<
+    "                    (median of 3 medians of 3) or median of a sample of ~sqrt(size) elements;\n" <<
+    "                    with any rule, after 2*log2(size) divisions a range is heapsorted, so\n" <<
+    "                    sorted or organ-pipe inputs are not quadratic anymore\n" <<
+    "\033[1mselect\033[0m :: quicksort going on only in the range with rank k, as std::nth_element: the k-th\n" <<
+    "          element in place, the smaller ones before and the others after; the options of\n" <<
+    "          quicksort hold, the partitions of big ranges are still helped by idle workers.\n" <<
+    "          With chrono, the time of std::nth_element on the same input is in the statistics\n" <<
+    "          reportable as stdUs, in microseconds\n" <<
+    "    |__ \033[1mk\033[0m=int :: the rank (default size/2, the median)\n" <<
+    "\033[1mpartialsort\033[0m :: as select, going on in the ranges with ranks below k, as std::partial_sort:\n" <<
+    "               the k smallest elements sorted in front; stdUs is std::partial_sort\n" <<
+    "    |__ \033[1mk\033[0m=int :: the sorted elements (default size/2)\n" <<
+    "\033[1msamplesort\033[0m :: recursive samplesort, division in buckets by splitters from a random sample,\n" <<
+    "              elements equal to a splitter are kept together in an already sorted bucket\n" <<
+    "    |__ threshold :: a positive number denoting the size (default 16384)\n" <<
+    "    |__ \033[1mbuckets\033[0m=int :: splitters+1, a power of 2 up to 128 (default 64)\n" <<
+    "    |__ \033[1moversampling\033[0m=int :: sample elements per bucket (default 8); ranges up to\n" <<
+    "                           buckets*oversampling elements are sorted sequentially\n" <<
+    "    |__ \033[1mclassify\033[0m=int :: from this size on, the classification in buckets is done in\n" <<
+    "                       parallel by chunks with the idle workers of the workgroup (default 65536)\n" <<
+    "\033[1mradixsort\033[0m :: recursive MSD radix sort, division in 256 buckets by the most significant byte\n" <<
+    "             left; signed integers and floats are sorted through an order preserving key\n" <<
+    "    |__ threshold :: a positive number denoting the size (default 16384)\n" <<
+    "    |__ \033[1mlsd\033[0m=int :: up to this size a bucket is sorted by LSD passes on the bytes left (default 65536)\n" <<
+    "    |__ \033[1mclassify\033[0m=int :: from this size on, histograms and scatter are done in parallel by\n" <<
+    "                       chunks with the idle workers of the workgroup (default 65536)\n" <<
     "\n\n" <<
     
     "RANGES\n\n" <<
@@ -680,12 +1526,84 @@ void printAdditionalHelp(){
     "                respective files for later inspection\n" <<
     "\033[1minput\033[0m=filename\n" <<
     "\033[1minput\033[0m=[filenames] :: specify desired input files; they will be processed with std::cin, so use\n" <<
-    "                     recognized separators such as space or newline\n" <<
+    "                     recognized separators such as space or newline; files named *.bin are\n" <<
+    "                     binary data files instead: a 16 bytes header (DEIS, element size as uint32,\n" <<
+    "                     count as uint64) and the elements as a little endian array, read by mmap\n" <<
+    "\033[1minput.bin\033[0m=int\n" <<
+    "\033[1minput.bin\033[0m=[ints] :: as input=ints, but the random inputs are saved as binary data files\n" <<
+    "\033[1minput\033[0m=distribution:size\n" <<
+    "\033[1minput\033[0m=distribution:parameter:size :: an input generated in memory, in parallel, without files;\n" <<
+    "                size as 1000000 or 1e6. Each element depends only on the seed and its index:\n" <<
+    "        |__ \033[1muniform\033[0m :: any value of the type\n" <<
+    "        |__ \033[1msorted\033[0m, \033[1mreverse\033[0m :: distinct values spread over the range, in order or reversed\n" <<
+    "        |__ \033[1mfew\033[0m :: parameter (default 16) distinct values\n" <<
+    "        |__ \033[1mzipf\033[0m :: the rank r among size values with probability ~ 1/r^parameter (default 1)\n" <<
+    "        |__ \033[1morgan\033[0m :: organ pipe, increasing then decreasing\n" <<
+    "        |__ \033[1mgauss\033[0m :: normal, standard deviation parameter (default 0.125) of the range\n" <<
+    "        |__ \033[1malmost\033[0m :: sorted, then parameter% (default 1) of size swaps of random pairs\n" <<
+    "                with input.bin= the results of a generated input are binary data files\n" <<
+    "\033[1mseed\033[0m=int :: seed of the generated inputs, random by default\n" <<
     "\033[1mchrono\033[0m :: activate the high_resolution_clock of C++ std to measure execution time of the parallel\n" <<
     "          process only (works even for the sequential execution, threads=0)\n" <<
+    "\033[1mverify\033[0m :: after each run, out of the time measured, check in parallel chunks that the output\n" <<
+    "          is in order (the ranks put in place for select and partialsort) and, by an order\n" <<
+    "          independent hash of the elements, a permutation of the input; verified=1 or 0 is\n" <<
+    "          in the statistics reportable, and why not on the console\n" <<
+    "\033[1mprocesses\033[0m :: workers are separate processes instead of threads, attached to a shared memory\n" <<
+    "             segment holding data buffers and job descriptors; threads is then the number of\n" <<
+    "             processes. A worker process dying is reported and its job is given to the others:\n" <<
+    "             divide and base are run again exactly, a merge is run again on its inputs as they\n" <<
+    "             were left, counted as rerunImperas in the statistics (verify it); log is not\n" <<
+    "             collected from worker processes; not available for pmergesort\n" <<
+    "\033[1mlazy\033[0m :: lazy splitting: above threshold a worker goes on sequentially and packages some of\n" <<
+    "        its remaining children as jobs only when another worker is idle; the number of jobs\n" <<
+    "        created is in the statistics reportable; not available for pmergesort\n" <<
+    "\033[1mbatch\033[0m :: sibling base cases are done in a single job, with a branchless batched base for\n" <<
+    "         mergesort and umergesort; jobs and leaves (base cases reached by jobs) are in\n" <<
+    "         the statistics reportable; not available for pmergesort, not used with lazy\n" <<
+    "\033[1mlocality\033[0m :: workers are pinned on the cpus the process may use (taskset, cgroups), and a\n" <<
+    "            job carrying the address range of its data is offered first to idle workers\n" <<
+    "            sharing L2/L3 with the last toucher of that range;\n" <<
+    "            near/far offers are in the statistics reportable\n" <<
+    "\033[1moffer.cost\033[0m=int :: jobs estimated cheaper than int (~ elements touched, n*log2(n) for a sort)\n" <<
+    "                  are done by the worker creating them instead of being offered to idle ones;\n" <<
+    "                  the count of such jobs is keptLocal in the statistics reportable; 0 (default)\n" <<
+    "                  offers every job\n" <<
+    "\033[1mtenants\033[0m=int\n" <<
+    "\033[1mtenants\033[0m=[ints] :: weights of workgroups sharing the process wide worker pool, which keeps\n" <<
+    "                  running at most one worker per core: each tenant gets cores in proportion to\n" <<
+    "                  its weight (at least 1) and may use idle ones beyond that. The reported run is\n" <<
+    "                  the first tenant, the others are concurrent copies of it, with the same\n" <<
+    "                  options, on their own copy of the data, each with threads workers; a tenant\n" <<
+    "                  with weight 0 is out of the pool; parks are in the statistics reportable.\n" <<
+    "                  The merges and runs of the others are not reported, while cacheMisses,\n" <<
+    "                  branchMisses and peakMemory are of the whole process; not available for\n" <<
+    "                  pmergesort, extsort and with processes\n" <<
+    "\033[1mpool.size\033[0m=int :: running workers of the pool, by default the number of cores\n" <<
+    "\033[1mblock\033[0m=int :: size of the base case of mergesort, umergesort and pmergesort, up to 64\n" <<
+    "              (default 32, 2 being the classical one); blocks of ints are sorted in registers\n" <<
+    "              by a sorting network; the least run of nmergesort\n" <<
+    "\033[1msimd\033[0m=level :: instructions of the sorting network: scalar (insertion sort), avx2 or avx512;\n" <<
+    "                by default the best one supported by the cpu\n" <<
+    "\033[1mindex\033[0m=bits :: type of the indices of the sorting components: 64 bit (default) for inputs\n" <<
+    "                of any size, or 32 bit, less memory for the counts and runs of samplesort,\n" <<
+    "                radixsort and nmergesort, for inputs below 2^31 elements\n" <<
+    "\033[1mrecord\033[0m=bytes :: sort records of bytes bytes (16, 64, 100 or 256) instead of ints, compared by\n" <<
+    "                an 8 byte key, the int of the input, and moved whole; for mergesort, umergesort,\n" <<
+    "                kmergesort, nmergesort, pmergesort, quicksort, select and partialsort, with 64\n" <<
+    "                bit indices. The payload holds the position in the input, so verify sees a\n" <<
+    "                record parted from its key\n" <<
+    "\033[1mindirect\033[0m :: sort the (key, index) pairs of the records instead, ordered by both so that\n" <<
+    "            any sort is stable, then permute the records as the pairs in a parallel pass by\n" <<
+    "            blocks with prefetch; records of any size (default 100), also those of record=\n" <<
+    "            without a type of their own. The times to make the pairs (extractUs) and to\n" <<
+    "            permute (permuteUs) are in the statistics reportable, out of chrono, and with\n" <<
+    "            verify permuted=1 if each record is the one of its pair\n" <<
     "\033[1mresult\033[0m :: save results in distinct files; wheir names will be automatically generated by removing\n" <<
-    "          everything after the first . in the input filename and adding the suffix output\n" <<
-    "\033[1mresult\033[0m=filename :: save all results in the same specified file\n" <<
+    "          everything after the first . in the input filename and adding the suffix output, or\n" <<
+    "          bin for a binary input\n" <<
+    "\033[1mresult.file\033[0m=filename :: save all results in the same specified file; a binary data file,\n" <<
+    "                        written at once, if its name ends with .bin (one header and array per run)\n" <<
     "\033[1mlog\033[0m=[loggables] :: activate a separate thread, interacting with the user during the execution via\n" <<
     "        |          std::cin; when reading 1 it will print the recorded loggables in the specified\n" <<
     "        |          log.file; when reading any other value it will terminate\n" <<
@@ -712,6 +1630,24 @@ void printAdditionalHelp(){
     "            |__ \033[1mchrono\033[0m :: recorded time of execution\n" <<
     "            |__ \033[1mparameters\033[0m :: test specific parameters, by now unused... \n" <<
     "                              it could be used in umergesort\n" <<
+    "            |__ \033[1mstatistics\033[0m :: test specific statistics of the run, e.g. with processes the\n" <<
+    "                              cross-process hand-off latency of job descriptors\n" <<
+    "            |__ \033[1mcacheMisses\033[0m :: last level cache misses of the run, all workers included;\n" <<
+    "                               empty when perf events are not allowed (see perf_event_paranoid)\n" <<
+    "            |__ \033[1mspeedup\033[0m :: with chrono, time of the run with the first of threads over time of\n" <<
+    "                           this run, on the same input and threshold: list threads=[0,1..n]\n" <<
+    "                           to get the speedup curve with respect to the sequential execution\n" <<
+    "            |__ \033[1mbranchMisses\033[0m :: mispredicted branches of the run, as cacheMisses\n" <<
+    "            |__ \033[1mnsPerElement\033[0m :: with chrono, time of the run over the size of the input\n" <<
+    "            |__ \033[1mmergeThroughput\033[0m :: GB/s per core of the merges of mergesort, umergesort, pmergesort\n" <<
+    "                                   and kmergesort, bytes read and written over the time spent in\n" <<
+    "                                   them by all workers; each merge is timed, so it slows the run\n" <<
+    "                                   a bit; with processes, only the merges of the calling worker\n" <<
+    "            |__ \033[1mbytesMoved\033[0m :: bytes read and written by the merges of the mergesorts, as above\n" <<
+    "            |__ \033[1mpeakMemory\033[0m :: peak resident memory of the process during the run in KB (VmHWM),\n" <<
+    "                              input as read included; since the start of the process if the\n" <<
+    "                              kernel does not allow to reset it; with processes, only the\n" <<
+    "                              calling one\n" <<
     "\033[1mreport.file\033[0m=filename :: specify where the report will be saved\n" <<
     "\n" <<
     "\n" <<
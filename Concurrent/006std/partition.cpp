@@ -0,0 +1,112 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Branchless partition of V[0,n) by pred (BlockQuicksort, by   */
+/* Edelkamp and Weiss): the results of pred on a block from     */
+/* each end are stored as offsets of misplaced elements without */
+/* branching, then the misplaced elements are swapped in pairs; */
+/* the last 2 blocks at most are partitioned in the usual way   */
+template <class T, class P>
+int64_t branchlessPartition(T* V, const int64_t& n, P pred){
+    constexpr int B{128};
+    unsigned char offL[B], offR[B];
+    int nL{0}, nR{0}, sL{0}, sR{0};
+    if( n<=0 )
+        return 0;
+    T *l(V), *r(V+n-1);
+    while( r-l+1>2*B ){
+        if( nL==0 ){
+            sL = 0;
+            for( int k=0; k<B; ++k ){
+                offL[nL] = static_cast<unsigned char>(k);
+                nL += !pred(l[k]);
+            }
+        }
+        if( nR==0 ){
+            sR = 0;
+            for( int k=0; k<B; ++k ){
+                offR[nR] = static_cast<unsigned char>(k);
+                nR += pred(*(r-k));
+            }
+        }
+        const int num{std::min(nL, nR)};
+        for( int k=0; k<num; ++k )
+            std::swap(l[offL[sL+k]], *(r-offR[sR+k]));
+        nL -= num, nR -= num;
+        sL += num, sR += num;
+        if( nL==0 )
+            l += B;
+        if( nR==0 )
+            r -= B;
+    }
+    return std::partition(l, r+1, pred)-V;
+}
+
+/* Parallel in-place partition of V[0,n) by pred, returning how */
+/* many elements satisfy it, now in V[0,m):                     */
+/* participants claim blocks from both ends and swap misplaced  */
+/* elements between their left and right block; blocks left     */
+/* unfinished (at most one per side per participant) are moved */
+/* next to the unclaimed middle, which is then partitioned      */
+/* sequentially, together with the tail shorter than a block    */
+
+template <class T, class P>
+int64_t blockPartition(T* V, const int64_t& n, P pred, const int64_t& B = 1<<12){
+    const int64_t nb{n/B};
+    const int nP{static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(nb/2, 64)))};
+    std::atomic<int64_t> claimed{0}, nextL{0}, nextR{nb-1};
+    std::vector<int64_t> UL(nP, -1), UR(nP, -1);     /* unfinished blocks of participant k   */
+
+    auto claim = [&](std::atomic<int64_t>& next, const int64_t& step) -> int64_t {
+        if( claimed.fetch_add(1, std::memory_order_relaxed)>=nb )
+            return -1;
+        return next.fetch_add(step, std::memory_order_relaxed);
+    };
+
+    parallelFor(nP, [&](int k){
+        int64_t l{-1}, r{-1}, li{0}, ri{0}, le{0}, re{0};
+        while( true ){
+            if( li==le ){
+                if( (l=claim(nextL, 1))<0 )
+                    break;
+                li = l*B, le = li+B;
+            }
+            if( ri==re ){
+                if( (r=claim(nextR, -1))<0 )
+                    break;
+                ri = r*B, re = ri+B;
+            }
+            while( true ){
+                while( li<le && pred(V[li]) )
+                    ++li;
+                while( ri<re && !pred(V[ri]) )
+                    ++ri;
+                if( li==le || ri==re )
+                    break;
+                std::swap(V[li++], V[ri++]);
+            }
+        }
+        UL[k] = (l>=0 && li<le) ? l : -1;
+        UR[k] = (r>=0 && ri<re) ? r : -1;
+    });
+
+    /* left blocks are [0,L), right ones [R,nb): unfinished ones go to L-1, L-2... and R, R+1...   */
+    const int64_t L{std::min(nextL.load(), nb)}, R{std::max<int64_t>(nextR.load()+1, L)};
+    auto swapBlocks = [&](const int64_t& a, const int64_t& b){
+        if( a!=b )
+            std::swap_ranges(V+a*B, V+a*B+B, V+b*B);
+    };
+    std::sort(UL.begin(), UL.end(), std::greater<int64_t>());
+    std::sort(UR.begin(), UR.end());
+    int64_t ms{L}, me{R};
+    for( auto &u: UL )
+        if( u>=0 )
+            swapBlocks(u, --ms);
+    for( auto &u: UR )
+        if( u>=0 )
+            swapBlocks(u, me++);
+
+    int64_t m{ms*B+branchlessPartition(V+ms*B, (me-ms)*B, pred)};
+    for( int64_t t=nb*B; t<n; ++t )
+        if( pred(V[t]) )
+            std::swap(V[t], V[m++]);
+    return m;
+}
@@ -0,0 +1,86 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Hardware counters through perf_event_open: the counter is    */
+/* inherited by threads and processes created after start(),    */
+/* and their counts are added when they terminate               */
+
+class perfCounter{
+    int fd;
+
+    static int open(uint32_t type, uint64_t config){
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+public:
+    enum class event { cacheMisses, branchMisses };
+
+    explicit perfCounter(event e) : fd(-1) {
+        switch(e){
+        case event::cacheMisses:
+            fd = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ<<8) | (PERF_COUNT_HW_CACHE_RESULT_MISS<<16));
+            if( fd<0 )
+                fd = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            break;
+        case event::branchMisses:
+            fd = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+            break;
+        }
+    }
+
+    perfCounter(const perfCounter&) = delete;
+    perfCounter& operator=(const perfCounter&) = delete;
+
+    bool valid() const {
+        return fd>=0;
+    }
+
+    void start(){
+        if( fd<0 )
+            return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    /* "" if the counter is not available, i.e. not allowed by perf_event_paranoid  */
+    std::string stop(){
+        uint64_t count;
+        if( fd<0 )
+            return "";
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if( read(fd, &count, sizeof(count))!=sizeof(count) )
+            return "";
+        return std::to_string(count);
+    }
+
+    ~perfCounter(){
+        if( fd>=0 )
+            close(fd);
+    }
+};
+
+/* Peak resident memory of the process (VmHWM), reset by start() through */
+/* clear_refs when the kernel allows it, otherwise since the beginning  */
+class peakMemory{
+public:
+    void start(){
+        std::ofstream clear("/proc/self/clear_refs");
+        if( clear.is_open() )
+            clear << "5";
+    }
+
+    /* KB, "" if /proc is not readable  */
+    std::string stop(){
+        std::ifstream status("/proc/self/status");
+        for( std::string line; std::getline(status, line); )
+            if( line.compare(0, 6, "VmHWM:")==0 )
+                return std::to_string(std::stol(line.substr(6)));
+        return "";
+    }
+};
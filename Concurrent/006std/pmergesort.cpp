@@ -1,360 +1,261 @@
 /* License : Michele Miccinesi 2018 - 			*/
 /* Mergesort with Parallel merge components 	*/
 /* DBG */
-template <class T>
-bool checkOrder(std::vector<T>& V, int i,int j){
-    for( int k=i+1; k<=j; ++k )
+template <class T, class I>
+bool checkOrder(dataVector<T>& V, I i, I j){
+    for( I k=i+1; k<=j; ++k )
         if( V[k]<V[k-1] )
             return false;
     return true;
 }
 
-template <class T>
-bool printVector(std::vector<T>& V, int i, int j){
-    for( int k=i; k<=j; ++k )
+template <class T, class I>
+bool printVector(dataVector<T>& V, I i, I j){
+    for( I k=i; k<=j; ++k )
         std::cout << V[k] << ' ';
+    return true;
+}
+
+/* Merge path: the first k elements of the stable merge of A[0,nA) and */
+/* B[0,nB) are A[0,a) and B[0,k-a), with ties taken from A first; a is  */
+/* found by a binary search along the k-th cross diagonal              */
+template <class T, class I>
+inline I coRank(const T* A, const I& nA, const T* B, const I& nB, const I& k){
+    I l{std::max<I>(0, k-nB)}, h{std::min(k, nA)};
+    while( l<h ){
+        const I m{l+(h-l)/2};
+        if( B[k-m-1]<A[m] )
+            h=m;
+        else
+            l=m+1;
+    }
+    return l;
+}
+
+/* load balance of the parallel merges, when timeSlices: slices done,  */
+/* and the mean and the worst over the merges of the cpu time of the    */
+/* slowest slice over the mean one; cpu time, so preemptions don't count */
+bool timeSlices{false};
+std::atomic<uint64_t> mergeSlices{0}, slicedMerges{0}, sliceImbalance{0}, worstImbalance{0};   /* per mille */
+
+inline uint64_t threadNanos(){
+    timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return uint64_t(t.tv_sec)*1000000000u+t.tv_nsec;
 }
 
-/* WARNING: special cases are not covered because threshold MUST    */
-/* prevent them in all real cases!                                  */
-template <class T>
-inline std::pair<int, int> binarySearchRange(const std::vector<T>& V, const int& i, const int &j, const int &k){
-    T mid = V[j];
-    std::pair<int, int> range(j, j);
-    int l{i}, h;
-    if( i<=j && j<=k ){
-        h=j;
-        while(l<h){
-            int m{(l+h)>>1};
-            if( V[m]!=mid )
-                l=m+1;
-            else
-                h=m;
-        }
-        range.first = l;
-        l=j, h=k;
-        while(l<h){
-            int m{(l+h+1)>>1};
-            if( V[m]!=mid )
-                h=m-1;
-            else
-                l=m;
-        }
-        range.second = l;
-    } else {
-        h = k;
-        /* The FIRST >= mid */
-        while(l<h){    
-            int m{(l+h)>>1};
-            if( V[m]<mid )
-                l=m+1;
-            else
-                h=m;
-        }
-        {
-            int m{(l+h)>>1};
-            if( V[m]<mid )
-                l=m+1;
-            else
-                h=m;
-        }
-        range.first = l;
-        h = k;
-        /* The LAST <= mid */
-        while(l<h){
-            int m{(l+h+1)>>1};
-            if( V[m]>mid )
-                h=m-1;
-            else
-                l=m;
-        }
-        {
-            int m{(l+h+1)>>1};
-            if( V[m]>mid )
-                h=m-1;
-            else
-                l=m;
-        }
-        range.second = h;
+struct sliceTimes{
+    std::vector<uint64_t> ns;
+    std::atomic<int> left;
+    sliceTimes(const int& p) : ns(p, 0), left(p) {}
+
+    void done(const int& s, const uint64_t& t){
+        ns[s] = t;
+        if( left.fetch_sub(1, std::memory_order_acq_rel)!=1 )
+            return;
+        uint64_t sum{0}, max{0};
+        for( auto &x: ns )
+            sum += x, max = std::max(max, x);
+        const uint64_t r{sum>0 ? 1000*max*ns.size()/sum : 1000};
+        mergeSlices.fetch_add(ns.size(), std::memory_order_relaxed);
+        slicedMerges.fetch_add(1, std::memory_order_relaxed);
+        sliceImbalance.fetch_add(r, std::memory_order_relaxed);
+        for( uint64_t w(worstImbalance.load(std::memory_order_relaxed)); r>w && !worstImbalance.compare_exchange_weak(w, r, std::memory_order_relaxed); );
     }
-    return range;
+};
+
+inline void resetSliceStatistics(){
+    mergeSlices.store(0, std::memory_order_relaxed);
+    slicedMerges.store(0, std::memory_order_relaxed);
+    sliceImbalance.store(0, std::memory_order_relaxed);
+    worstImbalance.store(0, std::memory_order_relaxed);
+}
+
+inline std::string perMille(const uint64_t& r){
+    return std::to_string(r/1000)+"."+std::to_string(r%1000/100)+std::to_string(r%100/10)+std::to_string(r%10);
 }
 
-template <class T>
-inline std::pair<int, int> binarySearchRange(const std::vector<T>* V, const int& i, const int &j, const int &k){
-    return binarySearchRange<T>(*V, i, j, k);
+inline std::string sliceStatistics(){
+    const uint64_t m{slicedMerges.load(std::memory_order_relaxed)};
+    if( !timeSlices || m==0 )
+        return "";
+    return " slices="+std::to_string(mergeSlices.load(std::memory_order_relaxed))+" imbalance="+perMille(sliceImbalance.load(std::memory_order_relaxed)/m)
+        +" worstImbalance="+perMille(worstImbalance.load(std::memory_order_relaxed));
 }
 
-template <typename T>
+template <typename T, typename I = sortIndex>
 struct subVector{
     static int threshold;
     int depth;
     subVector() {};
-    subVector(int depth, std::vector<T>& V, std::vector<T>& W, const int& i, const int &j) : depth(depth), V(&V), W(&W), i(i), j(j) {}
-    subVector(int depth, std::vector<T>* V, std::vector<T>* W, const int& i, const int &j) : depth(depth), V(V), W(W), i(i), j(j) {}
-    std::vector<T>* V, *W;
-    int i, j;
+    subVector(int depth, dataVector<T>& V, dataVector<T>& W, const I& i, const I& j) : depth(depth), V(&V), W(&W), i(i), j(j) {}
+    subVector(int depth, dataVector<T>* V, dataVector<T>* W, const I& i, const I& j) : depth(depth), V(V), W(W), i(i), j(j) {}
+    dataVector<T>* V, *W;
+    I i, j;
 };
 
-template <>
-int subVector<int>::threshold = -10;
-
-template <typename T>
-struct subVectors{
-    bool trivial;
-    static int threshold;
-    int depth;
-    subVectors(std::vector<T>& V, std::vector<T>& W, const int& i1, const int &j1, const int &i2, const int &j2, const int& b, bool trivial = false) 
-    : trivial(trivial), depth(j1+j2-i1-i2+2), V(&V), W(&W), b(b) {
+template <typename T, typename I>
+int subVector<T, I>::threshold = -10;
+
+/* Slice s of p of the merge of V[i[0],j[0]] and V[i[1],j[1]] into W  */
+/* from i[0]: the outputs [b,e), counted from i[0], the p slices of a */
+/* merge differing in size by one at most; the inputs by merge path   */
+template <typename T, typename I = sortIndex>
+struct mergeSlice{
+    static int threshold;               /* output elements per slice    */
+    I depth;
+    mergeSlice(dataVector<T>* V, dataVector<T>* W, const I& i1, const I& j1, const I& i2, const I& j2, const I& b, const I& e, const std::shared_ptr<sliceTimes>& times, const int& s)
+    : depth(e-b), V(V), W(W), b(b), e(e), s(s), times(times) {
         i[0]=i1, i[1]=i2;
         j[0]=j1, j[1]=j2;
     }
-    subVectors(std::vector<T>* V, std::vector<T>* W, const int& i1, const int &j1, const int &i2, const int &j2, const int& b, bool trivial = false) 
-    : trivial(trivial), depth(j1+j2-i1-i2+2), V(V), W(W), b(b) {
-        i[0]=i1, i[1]=i2;
-        j[0]=j1, j[1]=j2;
-    }
-    std::vector<T>* V, *W;
-    int b, i[2], j[2];
+    dataVector<T>* V, *W;
+    I i[2], j[2], b, e;
+    int s;
+    std::shared_ptr<sliceTimes> times;
 };
 
-template <typename T>
-struct subVectors1{
-    static int threshold;
-    int depth;
-    subVectors1(std::vector<T>& V, std::vector<T>& W, const int& i, const int& j, const int &b)
-    : depth(j-i+1), V(&V), W(&W), b(b), i(i), j(j) {}
-    subVectors1(std::vector<T>* V, std::vector<T>* W, const int& i, const int& j, const int &b)
-    : depth(j-i+1), V(V), W(W), b(b), i(i), j(j) {}    
-    std::vector<T>* V, *W;
-    int b, i, j;
-};
+template <typename T, typename I>
+int mergeSlice<T, I>::threshold = 1<<13;
 
-template <>
-int subVectors<int>::threshold = (1<<13)-1;
-template <>
-int subVectors1<int>::threshold = 1<<13;
+/* for locality aware placement of jobs: where the data is read from */
+/* NOTE: not for subVector<T, I>*, pointing to an output not yet ready  */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V->data()+V.i, V.V->data()+V.j+1);
+}
 
-template <class T>
-auto divide = [](const subVector<T>& Vin) -> std::vector<subVector<T>>{
-    std::vector<subVector<T>> Vout;
-    Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, Vin.i, (Vin.i+Vin.j)/2);
-    Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, (Vin.i+Vin.j)/2+1, Vin.j);
-    return Vout;
-};
+template <class T, class I>
+memoryRange dataRange(const mergeSlice<T, I>& V){
+    return memoryRange(V.V->data()+V.i[0], V.V->data()+V.j[1]+1);
+}
 
-template <class T>
-auto mergeDivide = [](const subVectors<T>& Vin) -> std::vector<subVectors<T>>{
-    std::vector<subVectors<T>> Vout;
-
-    int b = Vin.b;
-    int length0{Vin.j[0]-Vin.i[0]+1}, length1{Vin.j[1]-Vin.i[1]+1};
-    int m { length0<length1 ? (Vin.i[1]+Vin.j[1])>>1: (Vin.i[0]+Vin.j[0])>>1 };
-    auto range0 {binarySearchRange(Vin.V, Vin.i[0], m, Vin.j[0])};
-    auto range1 {binarySearchRange(Vin.V, Vin.i[1], m, Vin.j[1])};
-
-    int length = range0.first-Vin.i[0] + range1.first-Vin.i[1];
-    if( length )
-        Vout.emplace_back(Vin.V, Vin.W, Vin.i[0], range0.first-1, Vin.i[1], range1.first-1, b, range0.first==Vin.i[0] || range1.first==Vin.i[1]);
-    
-    b += length;
-    Vout.emplace_back(Vin.V, Vin.W, range0.first, range0.second, range1.first, range1.second, b, true);
-    
-    b += range0.second-range0.first + range1.second-range1.first+2;
-    length = Vin.j[0]-range0.second + Vin.j[1]-range1.second;
-    if( length )
-        Vout.emplace_back(Vin.V, Vin.W, range0.second+1, Vin.j[0], range1.second+1, Vin.j[1], b, range0.second==Vin.j[0] || range1.second==Vin.j[1]);
-    
-    return Vout;
-};
+/* for offering only jobs worth the hand-off: sort and merge  */
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return sortCost(V.j-V.i+1);
+}
+
+template <class T, class I>
+uint64_t jobCost(const mergeSlice<T, I>& V){
+    return V.depth;
+}
 
-template <class T>
-auto copyDivide = [](const subVectors1<T>& Vin) -> std::vector<subVectors1<T>> {
-    std::vector<subVectors1<T>> Vout;
-    int mid = (Vin.i+Vin.j)>>1;
-    Vout.emplace_back(Vin.V, Vin.W, Vin.i, mid, Vin.b);
-    Vout.emplace_back(Vin.V, Vin.W, mid+1, Vin.j, Vin.b+mid+1-Vin.i);
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    std::vector<subVector<T, I>> Vout;
+    Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, Vin.i, (Vin.i+Vin.j)/2);
+    Vout.emplace_back(Vin.depth-1, Vin.V, Vin.W, (Vin.i+Vin.j)/2+1, Vin.j);
     return Vout;
 };
 
-template <class T>
-auto impera = [](const std::vector<subVector<T>>& Vin) -> subVector<T>{
-    subVector<T> Vout (Vin[0].depth+1, Vin[0].W, Vin[0].V, Vin[0].i, Vin[1].j);
-    int ii[] = { Vin[0].i, Vin[1].i };
-    int i { Vin[0].i };  
-    while( true ){
-        bool b{(*(Vin[0].V))[ii[0]]>(*(Vin[1].V))[ii[1]]};
-        bool nb=!b;
-        (*Vout.V)[i++]=(*(Vin[b].V))[ii[b]++];
-        if( ii[b]>Vin[b].j ){
-            while( ii[nb]<=Vin[nb].j )
-                (*Vout.V)[i++]=(*(Vin[nb].V))[ii[nb]++];
-            break;
-        }
-    }
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout (Vin[0].depth+1, Vin[0].W, Vin[0].V, Vin[0].i, Vin[1].j);
+    mergeRuns(Vin[0].V->data()+Vin[0].i, Vin[0].j-Vin[0].i+1, Vin[1].V->data()+Vin[1].i, Vin[1].j-Vin[1].i+1, Vout.V->data()+Vin[0].i);
 
     return Vout;
 };
 
-template <class T>
-auto base = [](const subVector<T>& Vin) -> subVector<T>{
-    subVector<T> Vout{Vin.depth, Vin.W, Vin.V, Vin.i, Vin.j};
-    switch(Vin.j-Vin.i){
-    case 1:
-        if( (*Vin.V)[Vin.i]>(*Vin.V)[Vin.j] ){
-            (*Vout.V)[Vin.i]=(*Vin.V)[Vin.j];
-            (*Vout.V)[Vin.j]=(*Vin.V)[Vin.i];
-        } else {
-            (*Vout.V)[Vin.i]=(*Vin.V)[Vin.i];
-            (*Vout.V)[Vin.j]=(*Vin.V)[Vin.j];
-        }
-        break;
-    case 0:
-        (*Vout.V)[Vin.i]=(*Vin.V)[Vin.i];
-        break;
-    } 
+/* blocks up to sortBlock elements, by a sorting network for ints */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout{Vin.depth, Vin.W, Vin.V, Vin.i, Vin.j};
+    sortSmall(Vin.V->data()+Vin.i, Vout.V->data()+Vin.i, Vin.j-Vin.i+1);
     return Vout;
 };
 
-template <class T>
-auto mergeBase = [](const subVectors<T>& Vin) -> void {
-    int ii[] = { Vin.i[0], Vin.i[1] };
-    int i { Vin.b };  
-    while( true ){
-        bool b{(*Vin.V)[ii[0]]>(*Vin.V)[ii[1]]};
-        bool nb=!b;
-        (*Vin.W)[i++]=(*Vin.V)[ii[b]++];
-        if( ii[b]>Vin.j[b] ){
-            while( ii[nb]<=Vin.j[nb] )
-                (*Vin.W)[i++]=(*Vin.V)[ii[nb]++];
-            break;
-        }
-    }
-};
-
-template <class T>
-auto copyBase = [](const subVectors1<T>& V) -> void{
-    for( int ii=V.b, i=V.i; i<=V.j; ++i, ++ii )
-        (*V.W)[ii] = (*V.V)[i];
-};
-
-template <class T>
-auto isBase = [](const subVector<T>& V) -> bool{
-    return V.j-V.i<2;
-};
-
-template <class T>
-auto mergeIsBase = [](const subVectors<T>& V) -> bool {
-    return V.j[0]+V.j[1]-V.i[0]-V.i[1] < subVectors<T>::threshold;
+/* co-ranks of both ends of the slice, then a sequential merge */
+template <class T, class I>
+auto mergeBase = [](const mergeSlice<T, I>& Vin) -> void {
+    const uint64_t begin{timeSlices ? threadNanos() : 0};
+    const T *A(Vin.V->data()+Vin.i[0]), *B(Vin.V->data()+Vin.i[1]);
+    const I nA{Vin.j[0]-Vin.i[0]+1}, nB{Vin.j[1]-Vin.i[1]+1};
+    const I a0{coRank(A, nA, B, nB, Vin.b)}, a1{coRank(A, nA, B, nB, Vin.e)};
+    mergeRuns(A+a0, a1-a0, B+Vin.b-a0, Vin.e-a1-Vin.b+a0, Vin.W->data()+Vin.i[0]+Vin.b);
+    Vin.times->done(Vin.s, timeSlices ? threadNanos()-begin : 0);
 };
 
-template <class T>
-auto copyIsBase = [](const subVectors1<T>& V) -> bool {
-    return V.j-V.i < subVectors1<T>::threshold;
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.j-V.i+1<=std::max(2, sortBlock);
 };
 
-template <class T>
-std::function<subVector<T>(const subVector<T>&)> mergeSortRoutine = [](const subVector<T>& Vin) -> subVector<T>{
-    if( isBase<T>(Vin) )
-        return base<T>(Vin);
+template <class T, class I>
+std::function<subVector<T, I>(const subVector<T, I>&)> mergeSortRoutine = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    if( isBase<T, I>(Vin) )
+        return base<T, I>(Vin);
 
-    std::vector<subVector<T>> V;
-    for( auto &i: divide<T>(Vin) )
-        V.emplace_back(mergeSortRoutine<T>(std::cref(i)));
+    std::vector<subVector<T, I>> V;
+    for( auto &i: divide<T, I>(Vin) )
+        V.emplace_back(mergeSortRoutine<T, I>(std::cref(i)));
 
-    return impera<T>(V);
+    return impera<T, I>(V);
 };
 
-template <class T>
-std::function<bool(genericJob<subVectors1<T>, bool>&)> pCopyRoutine = [](genericJob<subVectors1<T>, bool>& myJob) -> bool{
-    if( copyIsBase<T>(myJob.in) ){
-        copyBase<T>(myJob.in);
-        return true;
-    }
-
-    for( auto &v: copyDivide<T>(myJob.in) ){
-        auto *copyJob{new genericJob<subVectors1<T>, bool>(pCopyRoutine<T>, std::vector<job*>(), v)};
-        myJob.OJ.emplace_back(copyJob);
-        myJob.DJ.push_back(copyJob);
-    }
+template <class T, class I>
+std::function<bool(genericJob<mergeSlice<T, I>, bool>&)> pMergeSliceRoutine = [](genericJob<mergeSlice<T, I>, bool>& myJob) -> bool {
+    mergeBase<T, I>(myJob.in);
     return true;
 };
 
-template <class T>
-std::function<bool(genericJob<subVectors<T>, bool>&)> pImperaRoutine = [](genericJob<subVectors<T>, bool>& myJob) -> bool {
-    if( mergeIsBase<T>(myJob.in) ){
-        mergeBase<T>(myJob.in);
-        return true;
-    }
-
-    for( auto &v: mergeDivide<T>(myJob.in) ){
-        if( v.trivial ){
-            if(v.j[0]>=v.i[0]){
-                subVectors1 sv(v.V, v.W, v.i[0], v.j[0], v.b);
-                auto *copyJob{new genericJob<subVectors1<T>, bool>(pCopyRoutine<T>, std::vector<job *>(), sv)};
-                myJob.OJ.emplace_back(copyJob);
-                myJob.DJ.push_back(copyJob);
-            }
-            if(v.j[1]>=v.i[1]){
-                subVectors1 sv(v.V, v.W, v.i[1], v.j[1], v.b+v.j[0]-v.i[0]+1);
-                auto *copyJob{new genericJob<subVectors1<T>, bool>(pCopyRoutine<T>, std::vector<job *>(), sv)};
-                myJob.OJ.emplace_back(copyJob);
-                myJob.DJ.push_back(copyJob);
-            }
-        }
-        else{
-            auto *mergeJob{new genericJob<subVectors<T>, bool>(pImperaRoutine<T>, std::vector<job *>(), v)};
-            myJob.OJ.emplace_back(mergeJob);
-            myJob.DJ.push_back(mergeJob);
-        }
-    }
-    return true;
-};
-
-template <class T>
-std::function<bool(genericJob<subVector<T>*,subVector<T>*>&)> imperaRoutine = [](genericJob<subVector<T>*,subVector<T>*>& myJob) -> bool {
-    typedef subVector<T> typeIn;
+template <class T, class I>
+std::function<bool(genericJob<subVector<T, I>*,subVector<T, I>*>&)> imperaRoutine = [](genericJob<subVector<T, I>*,subVector<T, I>*>& myJob) -> bool {
+    typedef subVector<T, I> typeIn;
 //  typedef typename std::remove_reference<decltype(myJob)>::type jobType;
     myJob.out = myJob.in;
 
     typeIn *in[2] = {static_cast<typeIn *>(myJob.IJ[0]->getOutput()), static_cast<typeIn *>(myJob.IJ[1]->getOutput())};
-    int i[2] = {in[0]->i, in[1]->i};
-    int j[2] = {in[0]->j, in[1]->j};
-    int b=i[0];
+    I i[2] = {in[0]->i, in[1]->i};
+    I j[2] = {in[0]->j, in[1]->j};
 
-    if( j[1]-i[0]<subVectors<T>::threshold ){
-        std::vector<subVector<T>> Vin { *in[0], *in[1] };
-        *myJob.in = impera<T>(Vin);
+    const I n{j[1]-i[0]+1};
+    if( n<2*mergeSlice<T, I>::threshold ){
+        std::vector<subVector<T, I>> Vin { *in[0], *in[1] };
+        *myJob.in = impera<T, I>(Vin);
         return true;
     }
 
-    subVectors<T> V( in[0]->V, in[0]->W, i[0], j[0], i[1], j[1], b );
-    *myJob.in = subVector<T>(in[0]->depth+1, V.W, V.V, i[0], j[1]);     /* swap V<->W as due!   */
-
-    auto *pImperaJob {new genericJob<subVectors<T>, bool>(pImperaRoutine<T>, std::vector<job*>(), V)};
-    myJob.OJ.emplace_back(pImperaJob);
-    myJob.DJ.emplace_back(pImperaJob);
+    /* the runs end in the buffer of the parity of their leaves: when  */
+    /* they are not in the same one (e.g. 8193 = 4097+4096 with blocks */
+    /* of 32), the smaller run is copied to the buffer of the other, as */
+    /* the slices read both runs from one buffer and write the other    */
+    const int big{j[0]-i[0]>=j[1]-i[1] ? 0 : 1};
+    dataVector<T> *from(in[big]->V), *to(in[big]->W);
+    if( in[1-big]->V!=from )
+        std::copy(in[1-big]->V->begin()+i[1-big], in[1-big]->V->begin()+j[1-big]+1, from->begin()+i[1-big]);
+
+    *myJob.in = subVector<T, I>(in[0]->depth+1, to, from, i[0], j[1]);     /* swap V<->W as due!   */
+
+    const int p{static_cast<int>(n/mergeSlice<T, I>::threshold)};
+    std::shared_ptr<sliceTimes> times(std::make_shared<sliceTimes>(p));
+    for( int s=0; s<p; ++s ){
+        mergeSlice<T, I> V(from, to, i[0], j[0], i[1], j[1], static_cast<I>(int64_t(n)*s/p), static_cast<I>(int64_t(n)*(s+1)/p), times, s);
+        auto *sliceJob {new genericJob<mergeSlice<T, I>, bool>(pMergeSliceRoutine<T, I>, std::vector<job*>(), V)};
+        myJob.OJ.emplace_back(sliceJob);
+        myJob.DJ.emplace_back(sliceJob);
+    }
     return true;   
 };
 
-template <class T>
-std::function<bool(genericJob<subVector<T>,subVector<T>>&)> pMergeSortRoutine = [](genericJob<subVector<T>, subVector<T>>& myJob) -> bool {
-    typedef subVector<T> typeIn;
+template <class T, class I>
+std::function<bool(genericJob<subVector<T, I>,subVector<T, I>>&)> pMergeSortRoutine = [](genericJob<subVector<T, I>, subVector<T, I>>& myJob) -> bool {
+    typedef subVector<T, I> typeIn;
 
-    if( isBase<T>(myJob.in) ){
-        myJob.out = base<T>(myJob.in);
+    if( isBase<T, I>(myJob.in) ){
+        myJob.out = base<T, I>(myJob.in);
         return true;
     }
 
-    if( myJob.in.depth < subVector<T>::threshold ){
-        myJob.out = mergeSortRoutine<T>(myJob.in);
+    if( myJob.in.depth < subVector<T, I>::threshold ){
+        myJob.out = mergeSortRoutine<T, I>(myJob.in);
         return true;
     }
  
-    for( auto &v: divide<T>(myJob.in) )
-        myJob.DJ.push_back(new genericJob<subVector<T>, subVector<T>>(pMergeSortRoutine<T>, std::vector<job *>(), v));
+    for( auto &v: divide<T, I>(myJob.in) )
+        myJob.DJ.push_back(new genericJob<subVector<T, I>, subVector<T, I>>(pMergeSortRoutine<T, I>, std::vector<job *>(), v));
 
-    auto *imperaJob{new genericJob<subVector<T>*, subVector<T>*>(imperaRoutine<T>, myJob.DJ, &myJob.out)};
+    auto *imperaJob{new genericJob<subVector<T, I>*, subVector<T, I>*>(imperaRoutine<T, I>, myJob.DJ, &myJob.out)};
     myJob.OJ.emplace_back(imperaJob);
     myJob.PJ.emplace_back(imperaJob);
     return true;
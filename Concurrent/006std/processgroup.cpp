@@ -0,0 +1,192 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* process workgroup: workers are forked processes sharing a    */
+/* mmap'ed segment; job descriptors are exchanged through a     */
+/* lock free queue in the segment, so a worker crashing does    */
+/* not bring down the others: its job is given back to the      */
+/* queue by the recover function of the user                    */
+
+class processgroup{
+public:
+    enum : uint32_t { divide=0, check=1 };
+    static constexpr uint32_t none{ ~uint32_t(0) };
+
+    struct descriptor{
+        uint32_t node, phase;
+        int32_t from;
+        int64_t stamp;
+    };
+
+    struct alignas(64) processData{
+        std::atomic<uint32_t> node;             /* what the process is working on   */
+        uint64_t jobs, handoffs, handoffSum, handoffMax;
+    };
+private:
+    const int n;
+    shmSegment S;
+    std::atomic<bool> *done;
+    processData *P;
+    shmQueue<descriptor> Q;
+    std::size_t userOffset;
+    std::vector<pid_t> pids;
+    uint32_t lost{0}, spins{0};
+    std::function<void(int)> recover;
+    std::chrono::duration<double> lastDuration;
+
+    static std::size_t queueOffset(int n){
+        return shmSegment::align(shmSegment::align(sizeof(std::atomic<bool>))+n*sizeof(processData));
+    }
+
+    static int64_t now(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /* only process 0, the parent, is reaping the others    */
+    void reap(){
+        int status;
+        for( int id=1; id<n; ++id ){
+            if( pids[id]<=0 )
+                continue;
+            if( waitpid(pids[id], &status, WNOHANG)==pids[id] ){
+                pids[id] = 0;
+                if( !WIFEXITED(status) || WEXITSTATUS(status)!=0 ){
+                    std::cout << "Warning: worker process P" << id << " terminated abnormally!" << std::endl;
+                    ++lost;
+                    if( recover )
+                        recover(id);
+                }
+            }
+        }
+    }
+public:
+    /* userBytes: room in the shared segment for the caller, see user() */
+    processgroup(int n, uint32_t capacity, std::size_t userBytes) : n(n),
+        S(queueOffset(n)+shmSegment::align(shmQueue<descriptor>::bytes(capacity))+userBytes),
+        done(S.at<std::atomic<bool>>(0)), P(S.at<processData>(shmSegment::align(sizeof(std::atomic<bool>)))),
+        Q(S.at<void>(queueOffset(n)), capacity), userOffset(queueOffset(n)+shmSegment::align(shmQueue<descriptor>::bytes(capacity))), pids(n, 0) {
+        new (done) std::atomic<bool>(false);
+        for( int i=0; i<n; ++i ){
+            new (&P[i].node) std::atomic<uint32_t>(none);
+            P[i].jobs = P[i].handoffs = P[i].handoffSum = P[i].handoffMax = 0;
+        }
+    }
+
+    processgroup(const processgroup&) = delete;
+    processgroup& operator=(const processgroup&) = delete;
+
+    template <class U>
+    U* user(){
+        return S.at<U>(userOffset);
+    }
+
+    bool valid() const {
+        return S.valid();
+    }
+
+    bool push(const int& id, const uint32_t& node, const uint32_t& phase){
+        return Q.push(descriptor{node, phase, id, now()});
+    }
+
+    bool pop(const int& id, descriptor& d){
+        if( !Q.pop(d) )
+            return false;
+        ++P[id].jobs;
+        if( d.from!=id ){
+            uint64_t h( now()-d.stamp );
+            ++P[id].handoffs;
+            P[id].handoffSum += h;
+            if( h>P[id].handoffMax )
+                P[id].handoffMax = h;
+        }
+        return true;
+    }
+
+    void working(const int& id, const uint32_t& node){
+        P[id].node.store(node, std::memory_order_relaxed);
+    }
+
+    uint32_t workingOn(const int& id){
+        return P[id].node.load(std::memory_order_relaxed);
+    }
+
+    void idle(const int& id){
+        if( id==0 && (++spins & 1023)==0 )
+            reap();
+        std::this_thread::yield();
+    }
+
+    void complete(){
+        done->store(true, std::memory_order_release);
+    }
+
+    bool isCompleted(){
+        return done->load(std::memory_order_acquire);
+    }
+
+    /* cycle(id) is run by every process; recover(id) by the parent     */
+    /* when process id dies while the group is still working            */
+    bool start(std::function<void(int)> cycle, std::function<void(int)> recover, bool wthChrono = false){
+        if( !valid() )
+            return false;
+        this->recover = recover;
+        std::cout << std::flush;
+
+        auto timeBegin = std::chrono::high_resolution_clock::now();
+        for( int id=1; id<n; ++id ){
+            pids[id] = fork();
+            if( pids[id]==0 ){
+                cycle(id);
+                _exit(0);
+            }
+            if( pids[id]<0 ){
+                std::cout << "Warning: cannot fork worker process P" << id << '!' << std::endl;
+                pids[id] = 0;
+            }
+        }
+        cycle(0);
+        auto timeEnd = std::chrono::high_resolution_clock::now();
+        if( wthChrono )
+            lastDuration = timeEnd-timeBegin;
+
+        int status;
+        for( int id=1; id<n; ++id )
+            if( pids[id]>0 ){
+                waitpid(pids[id], &status, 0);
+                pids[id] = 0;
+            }
+        return true;
+    }
+
+    std::vector<std::string> printData(){
+        std::vector<std::string> S;
+        for( int id=0; id<n; ++id )
+            S.emplace_back("P"+std::to_string(id)+"=====> jobs: "+std::to_string(P[id].jobs)+" --- handoffs: "+std::to_string(P[id].handoffs)
+                +" --- avg handoff: "+std::to_string(P[id].handoffs ? P[id].handoffSum/P[id].handoffs : 0)+"ns --- max handoff: "+std::to_string(P[id].handoffMax)+"ns");
+        if( lost )
+            S.emplace_back("=====> lost processes: "+std::to_string(lost));
+        return S;
+    }
+
+    /* cross process hand-off latency, for the report   */
+    std::string getStatistics(){
+        uint64_t h{0}, hSum{0}, hMax{0};
+        for( int id=0; id<n; ++id ){
+            h += P[id].handoffs;
+            hSum += P[id].handoffSum;
+            hMax = std::max(hMax, P[id].handoffMax);
+        }
+        return "handoffs="+std::to_string(h)+" avg="+std::to_string(h ? hSum/h : 0)+"ns max="+std::to_string(hMax)+"ns";
+    }
+
+    std::chrono::duration<double> getDuration(){
+        return lastDuration;
+    }
+
+    ~processgroup(){
+        int status;
+        for( int id=1; id<n; ++id )
+            if( pids[id]>0 ){
+                kill(pids[id], SIGKILL);
+                waitpid(pids[id], &status, 0);
+            }
+    }
+};
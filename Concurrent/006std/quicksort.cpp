@@ -1,23 +1,149 @@
 /* License : Michele Miccinesi 2018 -       */
 /* Quicksort components                     */
 
-template <typename T>
+enum class pivotRule { last, median3, ninther, sample };
+
+/* budget: divisions left before falling back to heapsort (introsort),  */
+/* 2*log2(size) when not given. Only the ranks in [lowRank,highRank]    */
+/* are put in place: a range without them is left as partitioned, so   */
+/* that a single rank is a selection (nth_element) and a prefix of the */
+/* ranks a partial sort                                                 */
+template <typename T, typename I = sortIndex>
 struct subVector{
     static int threshold;
-    const int depth;
-    subVector(std::vector<T>& V, const int& i, const int &j) : depth(j-i+1), V(V), i(i), j(j) {}
-    std::vector<T>& V;
-    int i, j;
+    static int partitionSize;           /* from here divide is helped by idle workers  */
+    static bool branchless;             /* sequential divide without branches          */
+    static pivotRule pivot;
+    static I lowRank, highRank;
+    const I depth;
+    subVector(dataVector<T>& V, const I& i, const I& j, const int& budget = -1) : depth(j-i+1), V(V), i(i), j(j), 
+        budget(budget>=0 ? budget : 2*(j>i ? 64-__builtin_clzll(j-i+1) : 1)) {}
+    dataVector<T>& V;
+    I i, j;
+    int budget;
 };
 
-template <>
-int subVector<int>::threshold = 0;
+template <typename T, typename I>
+int subVector<T, I>::threshold = 0;
+template <typename T, typename I>
+int subVector<T, I>::partitionSize = 1<<16;
+template <typename T, typename I>
+bool subVector<T, I>::branchless = true;
+template <typename T, typename I>
+pivotRule subVector<T, I>::pivot = pivotRule::last;
+template <typename T, typename I>
+I subVector<T, I>::lowRank = 0;
+template <typename T, typename I>
+I subVector<T, I>::highRank = std::numeric_limits<I>::max();
+
+/* no rank to put in place in V */
+template <class T, class I>
+inline bool outsideRanks(const subVector<T, I>& V){
+    return V.j<subVector<T, I>::lowRank || V.i>subVector<T, I>::highRank;
+}
+
+template <class T, class I>
+inline I median3(const dataVector<T>& V, const I& a, const I& b, const I& c){
+    if( V[a]<V[b] )
+        return V[b]<V[c] ? b : (V[a]<V[c] ? c : a);
+    return V[a]<V[c] ? a : (V[b]<V[c] ? c : b);
+}
+
+/* the pivot chosen by the rule is moved in j, where divide takes it   */
+template <class T, class I>
+void selectPivot(const subVector<T, I>& Vin){
+    const I n{Vin.j-Vin.i+1}, i{Vin.i}, j{Vin.j};
+    I p{j};
+    if( n<3 )
+        return;
+    switch(subVector<T, I>::pivot){
+    case pivotRule::last:
+        return;
+    case pivotRule::median3:
+        p = median3(Vin.V, i, i+n/2, j);
+        break;
+    case pivotRule::ninther:
+        if( n<128 )
+            p = median3(Vin.V, i, i+n/2, j);
+        else {
+            const I s{n/8};
+            p = median3(Vin.V, median3(Vin.V, i, i+s, i+2*s), median3(Vin.V, i+3*s, i+4*s, i+5*s), median3(Vin.V, i+6*s, i+7*s, j));
+        }
+        break;
+    case pivotRule::sample:
+    {
+        /* median of ~sqrt(n) equally spaced elements, at most 1023 */
+        int k{1};
+        while( k*k<n && k<1023 )
+            k = 2*k+1;
+        std::vector<I> S;
+        for( int s=0; s<k; ++s )
+            S.push_back(i+static_cast<I>(int64_t(s)*(n-1)/std::max(1, k-1)));
+        std::nth_element(S.begin(), S.begin()+S.size()/2, S.end(), [&Vin](const I& a, const I& b) -> bool { return Vin.V[a]<Vin.V[b]; });
+        p = S[S.size()/2];
+        break;
+    }
+    }
+    std::swap(Vin.V[p], Vin.V[j]);
+}
+
+/* for offering only jobs worth the hand-off */
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return outsideRanks(V) ? 0 : sortCost(V.j-V.i+1);
+}
+
+/* Parallel divide: < pivot | pivot | >= pivot; elements equal to the */
+/* pivot are gathered only when the pivot is the minimum, that is when */
+/* they would make the division unbalanced                             */
+template <class T, class I>
+std::vector<subVector<T, I>> parallelDivide(const subVector<T, I>& Vin){
+    std::vector<subVector<T, I>> Vout;
+    T *V(Vin.V.data());
+    const T pivot(V[Vin.j]);
+    I m{Vin.i+static_cast<I>(blockPartition(V+Vin.i, Vin.j-Vin.i, [&pivot](const T& x) -> bool { return x<pivot; }))};
+    std::swap(V[m], V[Vin.j]);
+    I r{m+1};
+    if( m==Vin.i )
+        r += static_cast<I>(blockPartition(V+m+1, Vin.j-m, [&pivot](const T& x) -> bool { return !(pivot<x); }));
+    Vout.emplace_back(Vin.V, Vin.i, m-1, Vin.budget-1);
+    Vout.emplace_back(Vin.V, r, Vin.j, Vin.budget-1);
+    return Vout;
+}
+
+/* Branchless divide: < pivot | == pivot | > pivot as the classical one, */
+/* the elements equal to the pivot are counted in the first partition   */
+/* (possibly more than once) and gathered by a second one, if any       */
+template <class T, class I>
+std::vector<subVector<T, I>> branchlessDivide(const subVector<T, I>& Vin){
+    std::vector<subVector<T, I>> Vout;
+    T *V(Vin.V.data());
+    const T pivot(V[Vin.j]);
+    I eq{0};
+    I m{Vin.i+static_cast<I>(branchlessPartition(V+Vin.i, Vin.j-Vin.i, [&pivot, &eq](const T& x) -> bool { 
+        eq += x==pivot; 
+        return x<pivot; 
+    }))};
+    std::swap(V[m], V[Vin.j]);
+    I r{m+1};
+    if( eq>0 )
+        r += static_cast<I>(branchlessPartition(V+m+1, Vin.j-m, [&pivot](const T& x) -> bool { return !(pivot<x); }));
+    Vout.emplace_back(Vin.V, Vin.i, m-1, Vin.budget-1);
+    Vout.emplace_back(Vin.V, r, Vin.j, Vin.budget-1);
+    return Vout;
+}
+
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    selectPivot(Vin);
+    if( Vin.j-Vin.i>=subVector<T, I>::partitionSize && helpAvailable() )
+        return parallelDivide(Vin);
+    if( subVector<T, I>::branchless )
+        return branchlessDivide(Vin);
 
-template <class T>
-auto divide = [](const subVector<T>& Vin) -> std::vector<subVector<T>>{
-    std::vector<subVector<T>> Vout;
+    std::vector<subVector<T, I>> Vout;
     
-    int i{Vin.i}, j{Vin.j}, k{Vin.j};
+    I i{Vin.i}, j{Vin.j}, k{Vin.j};
     const T pivot(Vin.V[j]);
     while( i<j ){
         if( Vin.V[i]>pivot ){
@@ -33,32 +159,37 @@ auto divide = [](const subVector<T>& Vin) -> std::vector<subVector<T>>{
         }
     }
 
-    int e{Vin.j};
-    Vout.emplace_back(Vin.V, Vin.i, j-1);
-    Vout.emplace_back(Vin.V, e-k+j+1, e);
+    I e{Vin.j};
+    Vout.emplace_back(Vin.V, Vin.i, j-1, Vin.budget-1);
+    Vout.emplace_back(Vin.V, e-k+j+1, e, Vin.budget-1);
     
     for( k = std::max(k, e-k+j+1); k<=e; ++k, ++j )
         std::swap(Vin.V[j], Vin.V[k]);
     return Vout;
 };
 
-template <class T>
-auto impera = [](const std::vector<subVector<T>>& Vin) -> subVector<T>{
-    subVector<T> Vout(Vin[0].V, Vin[0].i, Vin[1].j);
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout(Vin[0].V, Vin[0].i, Vin[1].j);
     return Vout;
 };
 
-template <class T>
-auto base = [](const subVector<T>& Vin) -> subVector<T>{
-    subVector<T> Vout{Vin.V, Vin.i, Vin.j};
-    if( Vout.j>Vout.i )
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout{Vin.V, Vin.i, Vin.j};
+    if( outsideRanks(Vin) )
+        return Vout;
+    if( Vout.j-Vout.i>1 ){              /* out of budget    */
+        std::make_heap(Vin.V.begin()+Vin.i, Vin.V.begin()+Vin.j+1);
+        std::sort_heap(Vin.V.begin()+Vin.i, Vin.V.begin()+Vin.j+1);
+    } else if( Vout.j>Vout.i )
         if( Vout.V[Vout.i]>Vout.V[Vout.j] )
             std::swap(Vout.V[Vout.i], Vout.V[Vout.j]);
 
     return Vout;
 };
 
-template <class T>
-auto isBase = [](const subVector<T>& V) -> bool{
-    return V.j-V.i<2;
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.j-V.i<2 || V.budget<=0 || outsideRanks(V);
 };
\ No newline at end of file
@@ -0,0 +1,184 @@
+/* License : Michele Miccinesi 2018 -       */
+/* Radix sort components                    */
+
+/* Keys as unsigned integers ordered as the values: the sign bit of */
+/* signed integers is flipped, negative floats are complemented     */
+template <class T>
+struct radixKey{
+    typedef typename std::make_unsigned<T>::type key;
+    static key get(const T& x){
+        return static_cast<key>(x) ^ (key(1)<<(8*sizeof(key)-1));
+    }
+};
+
+template <>
+struct radixKey<float>{
+    typedef uint32_t key;
+    static key get(const float& x){
+        key k;
+        std::memcpy(&k, &x, sizeof(k));
+        return k ^ (-(k>>31) | (key(1)<<31));
+    }
+};
+
+template <>
+struct radixKey<double>{
+    typedef uint64_t key;
+    static key get(const double& x){
+        key k;
+        std::memcpy(&k, &x, sizeof(k));
+        return k ^ (-(k>>63) | (key(1)<<63));
+    }
+};
+
+/* MSD division by the byte at shift, buckets are scattered from V to */
+/* W so the two buffers swap their roles at each division; ranges up  */
+/* to lsdSize elements are sorted by LSD passes on the bytes left     */
+template <typename T, typename I = sortIndex>
+struct subVector{
+    static int threshold;
+    static int lsdSize;
+    static int classifySize;            /* from here histograms and scatter are helped by idle workers  */
+    const I depth;
+    subVector(dataVector<T>& V, dataVector<T>& W, const I& i, const I& j, const int& shift = 8*(sizeof(typename radixKey<T>::key)-1), const bool& swapped = false) :
+        depth(j-i+1), V(V), W(W), i(i), j(j), shift(shift), swapped(swapped) {}
+    dataVector<T>& V, &W;
+    I i, j;
+    int shift;                          /* next byte, below 0 the range is sorted    */
+    bool swapped;                       /* the data are in the auxiliary buffer     */
+};
+
+template <typename T, typename I>
+int subVector<T, I>::threshold = 1<<14;
+template <typename T, typename I>
+int subVector<T, I>::lsdSize = 1<<16;
+template <typename T, typename I>
+int subVector<T, I>::classifySize = 1<<16;
+
+/* for locality aware placement of jobs */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V.data()+V.i, V.V.data()+V.j+1);
+}
+
+/* a pass per byte left */
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return uint64_t(V.j-V.i+1)*(V.shift/8+1);
+}
+
+template <class T>
+inline int digit(const T& x, const int& shift){
+    return static_cast<int>((radixKey<T>::get(x)>>shift) & 255);
+}
+
+/* scatter of src[a,b) in dst by byte, next[d] being where the next */
+/* element of digit d goes: elements are gathered in a cache line   */
+/* per digit and written a line at a time (write combining)         */
+template <class T, class I>
+void scatter(const T* src, T* dst, const I& a, const I& b, I* next, const int& shift){
+    constexpr int L{sizeof(T)>=64 ? 1 : static_cast<int>(64/sizeof(T))};
+    if( b-a<(L<<10) ){
+        for( I x=a; x<b; ++x )
+            dst[next[digit(src[x], shift)]++] = src[x];
+        return;
+    }
+    std::vector<T> line(256*L);
+    int fill[256]{};
+    for( I x=a; x<b; ++x ){
+        const int d{digit(src[x], shift)};
+        line[d*L+fill[d]++] = src[x];
+        if( fill[d]==L ){
+            std::copy(line.begin()+d*L, line.begin()+(d+1)*L, dst+next[d]);
+            next[d] += L;
+            fill[d] = 0;
+        }
+    }
+    for( int d=0; d<256; ++d )
+        std::copy(line.begin()+d*L, line.begin()+d*L+fill[d], dst+next[d]);
+}
+
+/* histograms per chunk, then bucket offsets: bucket d of chunk c starts */
+/* after bucket d of chunks before c; B[d] is where bucket d starts      */
+template <class T, class I>
+void histograms(const T* V, const I& n, const int& nC, const int& shift, std::vector<I>& C, std::vector<I>& B){
+    C.assign(nC*256, 0);
+    parallelFor(nC, [&](int c){
+        I *count(C.data()+c*256);
+        for( I x=static_cast<I>(int64_t(n)*c/nC); x<static_cast<I>(int64_t(n)*(c+1)/nC); ++x )
+            ++count[digit(V[x], shift)];
+    });
+    B.assign(257, 0);
+    I p{0};
+    for( int d=0; d<256; ++d ){
+        B[d] = p;
+        for( int c=0; c<nC; ++c ){
+            const I m{C[c*256+d]};
+            C[c*256+d] = p;
+            p += m;
+        }
+    }
+    B[256] = n;
+}
+
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    const I n{Vin.j-Vin.i+1};
+    const int nC{n>=subVector<T, I>::classifySize ? static_cast<int>(std::max<I>(1, std::min<I>(64, n>>12))) : 1};
+    T *V(Vin.V.data()+Vin.i), *W(Vin.W.data()+Vin.i);
+    std::vector<I> C, B;
+    std::vector<subVector<T, I>> Vout;
+
+    histograms(V, n, nC, Vin.shift, C, B);
+    for( int d=0; d<256; ++d )
+        if( B[d+1]-B[d]==n ){           /* a single bucket: nothing to move */
+            Vout.emplace_back(Vin.V, Vin.W, Vin.i, Vin.j, Vin.shift-8, Vin.swapped);
+            return Vout;
+        }
+    parallelFor(nC, [&](int c){
+        scatter(V, W, static_cast<I>(int64_t(n)*c/nC), static_cast<I>(int64_t(n)*(c+1)/nC), C.data()+c*256, Vin.shift);
+    });
+
+    for( int d=0; d<256; ++d )
+        if( B[d+1]>B[d] )
+            Vout.emplace_back(Vin.W, Vin.V, Vin.i+B[d], Vin.i+B[d+1]-1, Vin.shift-8, !Vin.swapped);
+    return Vout;
+};
+
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout(Vin.front().V, Vin.front().W, Vin.front().i, Vin.back().j, -8);
+    return Vout;
+};
+
+/* LSD passes on the bytes left, or std::sort for a few elements;   */
+/* the sorted range goes back to the original buffer                */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    const I n{Vin.j-Vin.i+1};
+    T *V(Vin.V.data()+Vin.i), *W(Vin.W.data()+Vin.i);
+    if( Vin.shift>=0 && n<=64 )
+        std::sort(V, V+n);
+    else if( Vin.shift>=0 ){
+        std::vector<I> C, B;
+        for( int shift=0; shift<=Vin.shift; shift+=8 ){
+            histograms(V, n, 1, shift, C, B);
+            bool single{false};
+            for( int d=0; d<256 && !single; ++d )
+                single = B[d+1]-B[d]==n;
+            if( single )
+                continue;
+            scatter(V, W, I(0), n, C.data(), shift);
+            std::swap(V, W);
+        }
+    }
+    T *target((Vin.swapped ? Vin.W.data() : Vin.V.data())+Vin.i);
+    if( V!=target )
+        std::copy(V, V+n, target);
+    return Vin.swapped ? subVector<T, I>(Vin.W, Vin.V, Vin.i, Vin.j, -8) : subVector<T, I>(Vin.V, Vin.W, Vin.i, Vin.j, -8);
+};
+
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.shift<0 || V.j-V.i+1<=subVector<T, I>::lsdSize;
+};
@@ -73,6 +73,7 @@ struct reader<std::string>{
                 return res;
             res += s[i++];
         }
+        return res;
     }
 };
 
@@ -0,0 +1,158 @@
+/* License : Michele Miccinesi 2018 -                               */
+/* Records sorted by an 8 byte key. The sorts compare elements by   */
+/* <, so the key and its order come with the element type: a record */
+/* is compared by its key and moved whole, or it is sorted          */
+/* indirectly, as a (key, index) pair, and the records are then     */
+/* permuted as the pairs                                            */
+
+/* the key of an element, the element itself for numbers */
+template <class T>
+struct sortKey{
+    static int64_t get(const T& x){
+        return static_cast<int64_t>(x);
+    }
+};
+
+/* bytes bytes, the first 8 the key: packed, so 100 bytes are 100 */
+template <int bytes>
+struct __attribute__((packed)) record{
+    int64_t key;
+    char payload[bytes-sizeof(int64_t)];
+
+    bool operator<(const record& r) const { return key<r.key; }
+    bool operator>(const record& r) const { return r.key<key; }
+    bool operator<=(const record& r) const { return !(r.key<key); }
+    bool operator>=(const record& r) const { return !(key<r.key); }
+    bool operator==(const record& r) const { return key==r.key; }
+    bool operator!=(const record& r) const { return key!=r.key; }
+};
+
+template <int bytes>
+struct sortKey<record<bytes>>{
+    static int64_t get(const record<bytes>& x){
+        return x.key;
+    }
+};
+
+template <int bytes>
+std::ostream& operator<<(std::ostream& out, const record<bytes>& x){
+    return out << x.key;
+}
+
+/* ordered by the key and then by the index, so that any sort of the */
+/* pairs is stable                                                   */
+struct keyIndex{
+    int64_t key;
+    uint64_t index;
+
+    bool operator<(const keyIndex& p) const { return key<p.key || (key==p.key && index<p.index); }
+    bool operator>(const keyIndex& p) const { return p<*this; }
+    bool operator<=(const keyIndex& p) const { return !(p<*this); }
+    bool operator>=(const keyIndex& p) const { return !(*this<p); }
+    bool operator==(const keyIndex& p) const { return key==p.key && index==p.index; }
+    bool operator!=(const keyIndex& p) const { return !(*this==p); }
+};
+
+template <>
+struct sortKey<keyIndex>{
+    static int64_t get(const keyIndex& x){
+        return x.key;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const keyIndex& x){
+    return out << x.key;
+}
+
+/* the element type of the inputs records are made from */
+template <class T>
+struct inputOf{
+    typedef T type;
+};
+
+template <int bytes>
+struct inputOf<record<bytes>>{
+    typedef int type;
+};
+
+template <>
+struct inputOf<keyIndex>{
+    typedef int type;
+};
+
+/* record x of the input, of bytes bytes with key k: the payload    */
+/* repeats x, so a record parted from its key is seen by verify     */
+inline void makeRecord(char* r, const std::size_t& bytes, const int64_t& k, const uint64_t& x){
+    std::memcpy(r, &k, sizeof(k));
+    for( std::size_t o=sizeof(k); o<bytes; o+=sizeof(x) )
+        std::memcpy(r+o, &x, std::min(sizeof(x), bytes-o));
+}
+
+template <class K, int bytes>
+void makeRecords(const std::vector<K>& keys, std::vector<record<bytes>>& R){
+    R.resize(keys.size());
+    forChunks(keys.size(), coreChunks(keys.size()), [&](int, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<e; ++x )
+            makeRecord(reinterpret_cast<char*>(&R[x]), bytes, keys[x], x);
+    });
+}
+
+/* records of a size known at run time, one after the other */
+template <class K>
+void makeRecords(const std::vector<K>& keys, std::vector<char>& R, const std::size_t& bytes){
+    R.resize(keys.size()*bytes);
+    forChunks(keys.size(), coreChunks(keys.size()), [&](int, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<e; ++x )
+            makeRecord(R.data()+x*bytes, bytes, keys[x], x);
+    });
+}
+
+/* the (key, index) pairs of the records R */
+inline void keyIndices(const std::vector<char>& R, const std::size_t& bytes, std::vector<keyIndex>& P){
+    P.resize(R.size()/bytes);
+    forChunks(P.size(), coreChunks(P.size()), [&](int, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<e; ++x ){
+            P[x].index = x;
+            std::memcpy(&P[x].key, R.data()+x*bytes, sizeof(P[x].key));
+        }
+    });
+}
+
+/* out[x] = in[P[x].index], records of bytes bytes, in parallel chunks: */
+/* out is written in order a block at a time, while the records of the  */
+/* next block, scattered in in, are prefetched                          */
+inline void permuteRecords(const keyIndex* P, const std::size_t& n, const char* in, char* out, const std::size_t& bytes){
+    constexpr std::size_t block{64};
+    forChunks(n, coreChunks(n), [&](int, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<std::min(e, b+block); ++x )
+            __builtin_prefetch(in+P[x].index*bytes);
+        for( std::size_t x0=b; x0<e; x0+=block ){
+            const std::size_t x1{std::min(e, x0+block)};
+            for( std::size_t x=x1; x<std::min(e, x1+block); ++x )
+                __builtin_prefetch(in+P[x].index*bytes);
+            for( std::size_t x=x0; x<x1; ++x )
+                std::memcpy(out+x*bytes, in+P[x].index*bytes, bytes);
+        }
+    });
+}
+
+/* out holds the records of the pairs P, their keys and their indices */
+/* (in the payload); the first one that does not, n if none           */
+inline std::size_t firstMispermuted(const keyIndex* P, const std::size_t& n, const char* out, const std::size_t& bytes){
+    const int nC{coreChunks(n)};
+    std::vector<std::size_t> F(nC, n);
+    forChunks(n, nC, [&](int c, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<e; ++x ){
+            int64_t k;
+            uint64_t i{P[x].index};
+            std::memcpy(&k, out+x*bytes, sizeof(k));
+            if( bytes>=sizeof(k)+sizeof(i) )
+                std::memcpy(&i, out+x*bytes+sizeof(k), sizeof(i));
+            if( k!=P[x].key || i!=P[x].index ){
+                F[c] = x;
+                return;
+            }
+        }
+    });
+    return *std::min_element(F.begin(), F.end());
+}
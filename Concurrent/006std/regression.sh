@@ -0,0 +1,32 @@
+#!/bin/bash
+# License : Michele Miccinesi 2018 -
+# Regression of the mergesorts on sizes just above a power of two, where
+# the two runs of a merge end in different buffers (e.g. 8193 = 4097+4096
+# with blocks of 32): every run must report verified=1.
+# Usage: ./regression.sh [path of the test binary, ./test by default]
+TEST=${1:-./test}
+SIZES=""
+for k in 13 14 15 16 17; do
+    p=$((1<<k))
+    SIZES="$SIZES,uniform:$((p+1)),uniform:$((p+2)),uniform:$((p+3))"
+done
+SIZES=${SIZES#,}
+REPORT=$(mktemp)
+FAILED=0
+for t in mergesort umergesort pmergesort kmergesort nmergesort; do
+    rm -f "$REPORT"
+    "$TEST" $t verify "input=[$SIZES]" "threads=[1,2,4]" "report=[threads,size,statistics]" "report.file=$REPORT" >/dev/null 2>&1
+    rc=$?
+    if [ $rc -ne 0 ]; then
+        echo "$t: FAILED (exit code $rc)"
+        FAILED=1
+    elif grep -q "verified=0" "$REPORT" || [ "$(grep -c "verified=1" "$REPORT")" -ne 45 ]; then
+        echo "$t: FAILED"
+        grep -v "verified=1" "$REPORT"
+        FAILED=1
+    else
+        echo "$t: OK"
+    fi
+done
+rm -f "$REPORT"
+exit $FAILED
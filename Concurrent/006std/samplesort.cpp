@@ -0,0 +1,143 @@
+/* License : Michele Miccinesi 2018 -       */
+/* Samplesort components                    */
+
+/* A range is divided in 2*buckets ranges by buckets-1 splitters picked */
+/* from a random sample of buckets*oversampling elements: each element  */
+/* descends the search tree of the splitters without branches and goes  */
+/* in the bucket between two splitters or, if equal to a splitter, in   */
+/* an equality bucket, which is already sorted. Elements are scattered  */
+/* from V to W, so the two buffers swap their roles at each division    */
+template <typename T, typename I = sortIndex>
+struct subVector{
+    static int threshold;
+    static int buckets;                 /* a power of 2, at most 128                        */
+    static int oversampling;
+    static int classifySize;            /* from here classification is helped by idle workers   */
+    const I depth;
+    subVector(dataVector<T>& V, dataVector<T>& W, const I& i, const I& j, const bool& swapped = false, const bool& sorted = false) :
+        depth(j-i+1), V(V), W(W), i(i), j(j), swapped(swapped), sorted(sorted) {}
+    dataVector<T>& V, &W;
+    I i, j;
+    bool swapped;                       /* the data are in the auxiliary buffer */
+    bool sorted;                        /* equality bucket                      */
+};
+
+template <typename T, typename I>
+int subVector<T, I>::threshold = 1<<14;
+template <typename T, typename I>
+int subVector<T, I>::buckets = 64;
+template <typename T, typename I>
+int subVector<T, I>::oversampling = 8;
+template <typename T, typename I>
+int subVector<T, I>::classifySize = 1<<16;
+
+/* for locality aware placement of jobs */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V.data()+V.i, V.V.data()+V.j+1);
+}
+
+/* for offering only jobs worth the hand-off */
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return V.sorted ? 0 : sortCost(V.j-V.i+1);
+}
+
+/* the sorted splitters S in tree order: the children of t are 2t, 2t+1 */
+template <class T>
+void fillTree(std::vector<T>& tree, const std::vector<T>& S, const int& t, int& s){
+    if( t>=static_cast<int>(tree.size()) )
+        return;
+    fillTree(tree, S, 2*t, s);
+    tree[t] = S[s++];
+    fillTree(tree, S, 2*t+1, s);
+}
+
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    const I n{Vin.j-Vin.i+1};
+    const int k{subVector<T, I>::buckets}, o{subVector<T, I>::oversampling};
+    int logK{0};
+    while( (1<<logK)<k )
+        ++logK;
+    T *V(Vin.V.data()+Vin.i), *W(Vin.W.data()+Vin.i);
+
+    std::vector<T> S, tree(k);
+    std::minstd_rand r(static_cast<uint32_t>(Vin.i)*2654435761u+n);
+    for( int s=0; s<k*o; ++s )       /* r() has 31 bits  */
+        S.push_back(V[(n>>31)>0 ? ((uint64_t(r())<<31)|r())%n : r()%n]);
+    std::sort(S.begin(), S.end());
+    for( int b=0; b<k-1; ++b )
+        S[b] = S[(b+1)*o-1];
+    S.resize(k-1);
+    int s{0};
+    fillTree(tree, S, 1, s);
+    S.push_back(S.back());
+
+    /* bucket b holds S[b-1] < x <= S[b], 2b+1 those equal to S[b]  */
+    auto classify = [&](const T& x) -> int {
+        int t{1};
+        for( int l=0; l<logK; ++l )
+            t = 2*t+(tree[t]<x);
+        t -= k;
+        return 2*t+((t<k-1) & !(x<S[t]));
+    };
+
+    const int nC{n>=subVector<T, I>::classifySize ? static_cast<int>(std::max<I>(1, std::min<I>(64, n>>12))) : 1};
+    std::vector<unsigned char> O(n);
+    std::vector<I> C(nC*2*k, 0);
+    auto chunk = [n, nC](const int& c) -> I { return static_cast<I>(int64_t(n)*c/nC); };
+
+    parallelFor(nC, [&](int c){
+        I *count(C.data()+c*2*k);
+        for( I x=chunk(c); x<chunk(c+1); ++x ){
+            O[x] = static_cast<unsigned char>(classify(V[x]));
+            ++count[O[x]];
+        }
+    });
+    std::vector<I> B(2*k+1, 0);
+    I p{0};
+    for( int b=0; b<2*k; ++b ){
+        B[b] = p;
+        for( int c=0; c<nC; ++c ){
+            const I m{C[c*2*k+b]};
+            C[c*2*k+b] = p;
+            p += m;
+        }
+    }
+    B[2*k] = n;
+    parallelFor(nC, [&](int c){
+        I *next(C.data()+c*2*k);
+        for( I x=chunk(c); x<chunk(c+1); ++x )
+            W[next[O[x]]++] = std::move(V[x]);
+    });
+
+    std::vector<subVector<T, I>> Vout;
+    for( int b=0; b<2*k; ++b )
+        if( B[b+1]>B[b] )
+            Vout.emplace_back(Vin.W, Vin.V, Vin.i+B[b], Vin.i+B[b+1]-1, !Vin.swapped, (b&1)==1);
+    return Vout;
+};
+
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout(Vin.front().V, Vin.front().W, Vin.front().i, Vin.back().j);
+    return Vout;
+};
+
+/* the sorted range goes back to the original buffer    */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    if( !Vin.sorted )
+        std::sort(Vin.V.begin()+Vin.i, Vin.V.begin()+Vin.j+1);
+    if( !Vin.swapped )
+        return subVector<T, I>(Vin.V, Vin.W, Vin.i, Vin.j);
+    std::move(Vin.V.begin()+Vin.i, Vin.V.begin()+Vin.j+1, Vin.W.begin()+Vin.i);
+    return subVector<T, I>(Vin.W, Vin.V, Vin.i, Vin.j);
+};
+
+/* below buckets*oversampling elements a sample is pointless   */
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.sorted || V.j-V.i+1<=subVector<T, I>::buckets*subVector<T, I>::oversampling;
+};
@@ -0,0 +1,163 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Shared memory: buffers and lock free queue visible to all    */
+/* the processes forked after their creation                    */
+/* NOTE: only memory mapped BEFORE the fork is shared, and it   */
+/*       is mapped at the same address in all processes, so     */
+/*       pointers and references into it can be exchanged       */
+
+/* When set, dataVector buffers are allocated in shared memory  */
+std::atomic<bool> shareBuffers{false};
+
+/* Data buffers of the sorting components: a std::vector which  */
+/* can live in anonymous shared memory, so that the same buffer */
+/* is seen by workers that are processes and not threads        */
+template <class T>
+struct shareableAllocator{
+    typedef T value_type;
+    static constexpr std::size_t header{64};    /* keeps alignment, stores the kind of allocation */
+
+    shareableAllocator() = default;
+    template <class U>
+    shareableAllocator(const shareableAllocator<U>&) {}
+
+    T* allocate(std::size_t n){
+        char *p;
+        if( shareBuffers.load(std::memory_order_relaxed) ){
+            void *m{ mmap(nullptr, n*sizeof(T)+header, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0) };
+            if( m==MAP_FAILED )
+                throw std::bad_alloc();
+            p = static_cast<char *>(m);
+            *reinterpret_cast<std::size_t *>(p) = 1;
+        } else {
+            p = static_cast<char *>(::operator new(n*sizeof(T)+header));
+            *reinterpret_cast<std::size_t *>(p) = 0;
+        }
+        return reinterpret_cast<T *>(p+header);
+    }
+
+    void deallocate(T* q, std::size_t n){
+        char *p{ reinterpret_cast<char *>(q)-header };
+        if( *reinterpret_cast<std::size_t *>(p) )
+            munmap(p, n*sizeof(T)+header);
+        else
+            ::operator delete(p);
+    }
+};
+
+template <class T, class U>
+bool operator==(const shareableAllocator<T>&, const shareableAllocator<U>&){ return true; }
+template <class T, class U>
+bool operator!=(const shareableAllocator<T>&, const shareableAllocator<U>&){ return false; }
+
+template <class T>
+using dataVector = std::vector<T, shareableAllocator<T>>;
+
+/* Index of the elements in the sorting components, their template   */
+/* parameter I: signed, as an empty range [i,j] has j=i-1; an int is  */
+/* enough up to 2^31-1 elements                                       */
+typedef std::ptrdiff_t sortIndex;
+
+/* Anonymous shared mapping, pages are committed only when touched  */
+class shmSegment{
+    const std::size_t n;
+    char *p;
+public:
+    explicit shmSegment(std::size_t n) : n(n),
+        p(static_cast<char *>(mmap(nullptr, n, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0))) {
+        if( p==MAP_FAILED )
+            p = nullptr;
+    }
+
+    shmSegment(const shmSegment&) = delete;
+    shmSegment& operator=(const shmSegment&) = delete;
+
+    static std::size_t align(std::size_t offset){
+        return (offset+63) & ~std::size_t(63);
+    }
+
+    bool valid() const {
+        return p!=nullptr;
+    }
+
+    template <class U>
+    U* at(std::size_t offset){
+        return reinterpret_cast<U *>(p+offset);
+    }
+
+    ~shmSegment(){
+        if( p )
+            munmap(p, n);
+    }
+};
+
+/* Bounded MPMC queue living in a shmSegment, every cell has its    */
+/* own sequence number so that producers and consumers only meet   */
+/* on the cell they are using (D. Vyukov's scheme)                  */
+/* T must be trivially copyable: it is crossing process boundaries  */
+template <class T>
+class shmQueue{
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shmQueue needs address free atomics");
+    static_assert(std::is_trivially_copyable<T>::value, "shmQueue elements are copied across processes");
+
+    struct cell{
+        std::atomic<uint64_t> seq;
+        T data;
+    };
+    struct alignas(64) end{
+        std::atomic<uint64_t> i;
+    };
+
+    uint64_t N;
+    end *b, *e;
+    cell *Q;
+public:
+    static std::size_t bytes(uint32_t n){
+        return 2*sizeof(end)+(uint64_t(ceilPow2(n))+1)*sizeof(cell);
+    }
+
+    /* construct it BEFORE forking, in memory of size bytes(n)  */
+    shmQueue(void *at, uint32_t n) : N(ceilPow2(n)), b(static_cast<end *>(at)), e(b+1), Q(reinterpret_cast<cell *>(e+1)) {
+        new (&b->i) std::atomic<uint64_t>(0);
+        new (&e->i) std::atomic<uint64_t>(0);
+        for( uint64_t i=0; i<=N; ++i )
+            new (&Q[i].seq) std::atomic<uint64_t>(i);
+    }
+
+    bool push(const T& o){
+        uint64_t te{e->i.load(std::memory_order_relaxed)};
+        cell *c;
+        while( true ){
+            c = &Q[te & N];
+            int64_t dif{ static_cast<int64_t>(c->seq.load(std::memory_order_acquire)-te) };
+            if( dif==0 ){
+                if( e->i.compare_exchange_weak(te, te+1, std::memory_order_relaxed) )
+                    break;
+            } else if( dif<0 )
+                return false;
+            else
+                te = e->i.load(std::memory_order_relaxed);
+        }
+        c->data = o;
+        c->seq.store(te+1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& o){
+        uint64_t tb{b->i.load(std::memory_order_relaxed)};
+        cell *c;
+        while( true ){
+            c = &Q[tb & N];
+            int64_t dif{ static_cast<int64_t>(c->seq.load(std::memory_order_acquire)-(tb+1)) };
+            if( dif==0 ){
+                if( b->i.compare_exchange_weak(tb, tb+1, std::memory_order_relaxed) )
+                    break;
+            } else if( dif<0 )
+                return false;
+            else
+                tb = b->i.load(std::memory_order_relaxed);
+        }
+        o = c->data;
+        c->seq.store(tb+N+1, std::memory_order_release);
+        return true;
+    }
+};
@@ -0,0 +1,275 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Kernels of the mergesorts: base blocks of up to 64 keys      */
+/* sorted in registers by a sorting network, and merges by a    */
+/* bitonic merge of registers, with AVX-512 or AVX2 as found at */
+/* runtime by CPUID; 64 bit keys need AVX-512, other types or a */
+/* machine without them go through insertion sort and a forward  */
+/* merge                                                         */
+
+enum class simdLevel { scalar, avx2, avx512 };
+
+inline simdLevel cpuSimdLevel(){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") )
+        return simdLevel::avx512;
+    if( __builtin_cpu_supports("avx2") )
+        return simdLevel::avx2;
+#endif
+    return simdLevel::scalar;
+}
+
+/* the level used, at most the one of the cpu; the size of the  */
+/* base case of the mergesorts, 2 being the classical one       */
+simdLevel sortSimd{cpuSimdLevel()};
+int sortBlock{32};
+
+/* out = stable merge of the sorted A[0,nA) and B[0,nB), forward one */
+/* element at a time: out may end where B ends (B at the end of out),  */
+/* as out[k] is written after B[k-nA] is read, which std::merge does   */
+/* not allow                                                           */
+template <class T>
+inline void mergeForward(const T* A, const std::ptrdiff_t& nA, const T* B, const std::ptrdiff_t& nB, T* out){
+    const T *eA(A+nA), *eB(B+nB);
+    while( A<eA && B<eB )
+        *out++ = *B<*A ? *B++ : *A++;
+    while( A<eA )
+        *out++ = *A++;
+    while( B<eB )
+        *out++ = *B++;
+}
+
+/* lane masks of the compare-exchanges: bit l is set when l&h   */
+constexpr unsigned laneMask(const int& h, const int& W){
+    return W==0 ? 0u : (laneMask(h, W-1) | (((W-1)&h) ? 1u<<(W-1) : 0u));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2{
+struct vec32{
+    typedef int key;
+    typedef __m256i reg;
+    static constexpr int W{8}, maxRegisters{8};
+    template <int m>
+    static reg permute(const reg& x){
+        return _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0^m, 1^m, 2^m, 3^m, 4^m, 5^m, 6^m, 7^m));
+    }
+    template <int h>
+    static reg blend(const reg& a, const reg& b){
+        return _mm256_blend_epi32(a, b, laneMask(h, W));
+    }
+    static reg reverse(const reg& x){
+        return permute<7>(x);
+    }
+    static reg min(const reg& a, const reg& b){
+        return _mm256_min_epi32(a, b);
+    }
+    static reg max(const reg& a, const reg& b){
+        return _mm256_max_epi32(a, b);
+    }
+    static reg load(const key* p){
+        return _mm256_load_si256(reinterpret_cast<const reg*>(p));
+    }
+    static void store(key* p, const reg& x){
+        _mm256_store_si256(reinterpret_cast<reg*>(p), x);
+    }
+    static reg loadu(const key* p){
+        return _mm256_loadu_si256(reinterpret_cast<const reg*>(p));
+    }
+    static void storeu(key* p, const reg& x){
+        _mm256_storeu_si256(reinterpret_cast<reg*>(p), x);
+    }
+};
+#include "sortingnetwork.cpp"
+};
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"            /* undefined operands in avx512fintrin.h  */
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+namespace avx512{
+struct vec32{
+    typedef int key;
+    typedef __m512i reg;
+    static constexpr int W{16}, maxRegisters{4};
+    template <int m>
+    static reg permute(const reg& x){
+        return _mm512_permutexvar_epi32(_mm512_setr_epi32(0^m, 1^m, 2^m, 3^m, 4^m, 5^m, 6^m, 7^m, 8^m, 9^m, 10^m, 11^m, 12^m, 13^m, 14^m, 15^m), x);
+    }
+    template <int h>
+    static reg blend(const reg& a, const reg& b){
+        return _mm512_mask_blend_epi32(static_cast<__mmask16>(laneMask(h, W)), a, b);
+    }
+    static reg reverse(const reg& x){
+        return permute<15>(x);
+    }
+    static reg min(const reg& a, const reg& b){
+        return _mm512_min_epi32(a, b);
+    }
+    static reg max(const reg& a, const reg& b){
+        return _mm512_max_epi32(a, b);
+    }
+    static reg load(const key* p){
+        return _mm512_load_si512(p);
+    }
+    static void store(key* p, const reg& x){
+        _mm512_store_si512(p, x);
+    }
+    static reg loadu(const key* p){
+        return _mm512_loadu_si512(p);
+    }
+    static void storeu(key* p, const reg& x){
+        _mm512_storeu_si512(p, x);
+    }
+};
+
+struct vec64{
+    typedef int64_t key;
+    typedef __m512i reg;
+    static constexpr int W{8}, maxRegisters{8};
+    template <int m>
+    static reg permute(const reg& x){
+        return _mm512_permutexvar_epi64(_mm512_setr_epi64(0^m, 1^m, 2^m, 3^m, 4^m, 5^m, 6^m, 7^m), x);
+    }
+    template <int h>
+    static reg blend(const reg& a, const reg& b){
+        return _mm512_mask_blend_epi64(static_cast<__mmask8>(laneMask(h, W)), a, b);
+    }
+    static reg reverse(const reg& x){
+        return permute<7>(x);
+    }
+    static reg min(const reg& a, const reg& b){
+        return _mm512_min_epi64(a, b);
+    }
+    static reg max(const reg& a, const reg& b){
+        return _mm512_max_epi64(a, b);
+    }
+    static reg load(const key* p){
+        return _mm512_load_si512(p);
+    }
+    static void store(key* p, const reg& x){
+        _mm512_store_si512(p, x);
+    }
+    static reg loadu(const key* p){
+        return _mm512_loadu_si512(p);
+    }
+    static void storeu(key* p, const reg& x){
+        _mm512_storeu_si512(p, x);
+    }
+};
+#include "sortingnetwork.cpp"
+};
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+/* out[0,n) = in[0,n) sorted; in and out may be the same */
+template <class T>
+void sortSmall(const T* in, T* out, const int& n){
+    if( in!=out )
+        std::copy(in, in+n, out);
+    for( int k=1; k<n; ++k ){
+        T x(out[k]);
+        int l{k};
+        for( ; l>0 && x<out[l-1]; --l )
+            out[l] = out[l-1];
+        out[l] = x;
+    }
+}
+
+inline void sortSmall(const int* in, int* out, const int& n){
+    if( n>2 && n<=64 ){
+#if defined(__x86_64__) || defined(__i386__)
+        if( sortSimd==simdLevel::avx512 ){
+            avx512::sortNetwork<avx512::vec32>(in, out, n);
+            return;
+        }
+        if( sortSimd==simdLevel::avx2 ){
+            avx2::sortNetwork<avx2::vec32>(in, out, n);
+            return;
+        }
+#endif
+    }
+    sortSmall<int>(in, out, n);
+}
+
+inline void sortSmall(const int64_t* in, int64_t* out, const int& n){
+#if defined(__x86_64__) || defined(__i386__)
+    if( n>2 && n<=64 && sortSimd==simdLevel::avx512 ){
+        avx512::sortNetwork<avx512::vec64>(in, out, n);
+        return;
+    }
+#endif
+    sortSmall<int64_t>(in, out, n);
+}
+
+/* out = merge of the sorted A[0,nA) and B[0,nB); A does not overlap */
+/* out, B either does not or is at the end of out (mergeHalfScratch): */
+/* the kernels write behind what they read                            */
+template <class T>
+void mergeKernel(const T* A, const std::ptrdiff_t& nA, const T* B, const std::ptrdiff_t& nB, T* out){
+    mergeForward(A, nA, B, nB, out);
+}
+
+inline void mergeKernel(const int* A, const std::ptrdiff_t& nA, const int* B, const std::ptrdiff_t& nB, int* out){
+#if defined(__x86_64__) || defined(__i386__)
+    if( sortSimd==simdLevel::avx512 && nA>=16 && nB>=16 ){
+        avx512::mergeNetwork<avx512::vec32>(A, nA, B, nB, out);
+        return;
+    }
+    if( sortSimd!=simdLevel::scalar && nA>=8 && nB>=8 ){
+        avx2::mergeNetwork<avx2::vec32>(A, nA, B, nB, out);
+        return;
+    }
+#endif
+    mergeKernel<int>(A, nA, B, nB, out);
+}
+
+inline void mergeKernel(const int64_t* A, const std::ptrdiff_t& nA, const int64_t* B, const std::ptrdiff_t& nB, int64_t* out){
+#if defined(__x86_64__) || defined(__i386__)
+    if( sortSimd==simdLevel::avx512 && nA>=8 && nB>=8 ){
+        avx512::mergeNetwork<avx512::vec64>(A, nA, B, nB, out);
+        return;
+    }
+#endif
+    mergeKernel<int64_t>(A, nA, B, nB, out);
+}
+
+/* bytes read and written by merges, when countMerges, and their time */
+/* summed over the workers, when timeMerges: their ratio is GB/s/core; */
+/* not the merges of uncounted threads                                 */
+bool countMerges{false}, timeMerges{false};
+std::atomic<uint64_t> mergedBytes{0}, mergeNanos{0};
+
+template <class F>
+void accountMerge(const uint64_t& bytes, F merge){
+    if( !timeMerges || uncounted ){
+        merge();
+        if( countMerges && !uncounted )
+            mergedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return;
+    }
+    const auto begin(std::chrono::steady_clock::now());
+    merge();
+    mergeNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-begin).count(), std::memory_order_relaxed);
+    mergedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+template <class T>
+void mergeRuns(const T* A, const std::ptrdiff_t& nA, const T* B, const std::ptrdiff_t& nB, T* out){
+    accountMerge(2*sizeof(T)*(nA+nB), [&](){ mergeKernel(A, nA, B, nB, out); });
+}
+
+/* V[0,nL+nR) = merge of the sorted V[0,nL) and V[nL,nL+nR), with the */
+/* first run copied in S[0,nL) and merged back from there             */
+template <class T>
+void mergeHalfScratch(T* V, const std::ptrdiff_t& nL, const std::ptrdiff_t& nR, T* S){
+    accountMerge(2*sizeof(T)*(2*nL+nR), [&](){
+        std::copy(V, V+nL, S);
+        mergeKernel(static_cast<const T*>(S), nL, static_cast<const T*>(V+nL), nR, V);
+    });
+}
@@ -0,0 +1,126 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Bitonic sorting network on R registers of vec::W keys, with  */
+/* R a power of 2: every stage compares element g with g^m and  */
+/* keeps the max where g&h, so that reversing the second half   */
+/* of a block (m=2h-1) takes the place of descending blocks.    */
+/* Included once per instruction set, in its own namespace,    */
+/* after the definitions of the vec types for that set         */
+
+/* compare-exchange of lanes l and l^m, max where l&h */
+template <class vec, int m, int h>
+inline typename vec::reg lanes(const typename vec::reg& x){
+    const typename vec::reg y(vec::template permute<m>(x));
+    return vec::template blend<h>(vec::min(x, y), vec::max(x, y));
+}
+
+/* lanes l and l^d for d=h..1: the second half of a bitonic merge   */
+template <class vec, int h>
+inline typename vec::reg cleanLanes(typename vec::reg x){
+    if constexpr( h>0 ){
+        x = lanes<vec, h, h>(x);
+        x = cleanLanes<vec, h/2>(x);
+    }
+    return x;
+}
+
+/* bitonic merges of blocks of s lanes, s=2..W  */
+template <class vec, int s>
+inline typename vec::reg sortLanes(typename vec::reg x){
+    if constexpr( s>1 ){
+        x = sortLanes<vec, s/2>(x);
+        x = lanes<vec, s-1, s/2>(x);
+        x = cleanLanes<vec, s/4>(x);
+    }
+    return x;
+}
+
+/* a and b sorted: a gets the lower half of both, b the upper one  */
+template <class vec>
+inline void mergeRegisters(typename vec::reg& a, typename vec::reg& b){
+    const typename vec::reg y(vec::reverse(b));
+    b = cleanLanes<vec, vec::W/2>(vec::max(a, y));
+    a = cleanLanes<vec, vec::W/2>(vec::min(a, y));
+}
+
+/* R[0,R) in ascending order, lane by lane and register by register  */
+template <class vec>
+inline void sortRegisters(typename vec::reg* R, const int& nR){
+    for( int r=0; r<nR; ++r )
+        R[r] = sortLanes<vec, vec::W>(R[r]);
+    for( int s=2; s<=nR; s*=2 )
+        for( int b=0; b<nR; b+=s ){
+            for( int r=0; r<s/2; ++r ){
+                const typename vec::reg y(vec::reverse(R[b+s-1-r]));
+                R[b+s-1-r] = vec::reverse(vec::max(R[b+r], y));
+                R[b+r] = vec::min(R[b+r], y);
+            }
+            for( int d=s/4; d>0; d/=2 )
+                for( int r=b; r<b+s; ++r )
+                    if( (r&d)==0 ){
+                        const typename vec::reg lo(vec::min(R[r], R[r+d]));
+                        R[r+d] = vec::max(R[r], R[r+d]);
+                        R[r] = lo;
+                    }
+            for( int r=b; r<b+s; ++r )
+                R[r] = cleanLanes<vec, vec::W/2>(R[r]);
+        }
+}
+
+/* out[0,n) = in[0,n) sorted, n up to W*maxRegisters; in and out may */
+/* be the same; missing lanes are filled with the largest key        */
+template <class vec>
+inline void sortNetwork(const typename vec::key* in, typename vec::key* out, const int& n){
+    typedef typename vec::key key;
+    alignas(64) key buffer[vec::W*vec::maxRegisters];
+    typename vec::reg R[vec::maxRegisters];
+    int nR{1};
+    while( nR*vec::W<n )
+        nR *= 2;
+    std::copy(in, in+n, buffer);
+    std::fill(buffer+n, buffer+nR*vec::W, std::numeric_limits<key>::max());
+    for( int r=0; r<nR; ++r )
+        R[r] = vec::load(buffer+r*vec::W);
+    sortRegisters<vec>(R, nR);
+    for( int r=0; r<nR; ++r )
+        vec::store(buffer+r*vec::W, R[r]);
+    std::copy(buffer, buffer+n, out);
+}
+
+/* out[0,nA+nB) = merge of the sorted A and B, both of at least W    */
+/* keys, out not overlapping A and either not overlapping B or with  */
+/* B at its end: a register of the smallest keys left is stored at   */
+/* each step, behind what is loaded, the next block coming from the  */
+/* input with the smaller next key; when that input has less than a  */
+/* block left, it is merged with the last register in a buffer and   */
+/* then forward with the other, which may be under out               */
+template <class vec>
+inline void mergeNetwork(const typename vec::key* A, const std::ptrdiff_t& nA, const typename vec::key* B, const std::ptrdiff_t& nB, typename vec::key* out){
+    typedef typename vec::key key;
+    constexpr int W{vec::W};
+    std::ptrdiff_t a{W}, b{W};
+    bool fromA;
+    typename vec::reg lo(vec::loadu(A)), hi(vec::loadu(B));
+    while( true ){
+        mergeRegisters<vec>(lo, hi);
+        vec::storeu(out, lo);
+        out += W;
+        fromA = b>=nB || (a<nA && A[a]<=B[b]);
+        if( fromA && a+W<=nA ){
+            lo = vec::loadu(A+a);
+            a += W;
+        } else if( !fromA && b+W<=nB ){
+            lo = vec::loadu(B+b);
+            b += W;
+        } else
+            break;
+    }
+    alignas(64) key H[W], T[2*W];
+    vec::store(H, hi);
+    if( fromA ){
+        key *t(std::merge(H, H+W, A+a, A+nA, T));
+        mergeForward<key>(T, t-T, B+b, nB-b, out);
+    } else {
+        key *t(std::merge(H, H+W, B+b, B+nB, T));
+        mergeForward<key>(T, t-T, A+a, nA-a, out);
+    }
+}
@@ -19,6 +19,21 @@ namespace quickSort {
 namespace pMergeSort {
 #include "pmergesort.cpp"
 }
+namespace sampleSort {
+#include "samplesort.cpp"
+}
+namespace radixSort {
+#include "radixsort.cpp"
+}
+namespace kMergeSort {
+#include "kmergesort.cpp"
+}
+namespace natMergeSort {
+#include "nmergesort.cpp"
+}
+namespace extSort {
+#include "extsort.cpp"
+}
 #include <limits>
 namespace parser {
 #include "parser.cpp"
@@ -8,6 +8,10 @@ private:
     funcType seqFunc;
     job *parJob;
     std::chrono::duration<double> lastDuration;
+    std::string lastStatistics;
+    bool locality{false};
+    uint64_t offerCost{0};
+    int shareWeight{0};
 public:
     setTest(funcType seq, job *par) : seqFunc(seq), parJob(par) {}
 
@@ -26,7 +30,9 @@ public:
             }
         }
 
-        workgroup wg(nThreads);
+        workgroup wg(nThreads, locality);
+        wg.setOfferCost(offerCost);
+        wg.setShare(shareWeight);
         if( plogMe )
             wg.start(parJob, *plogMe, wthChrono);
         else 
@@ -36,6 +42,7 @@ public:
         for( auto &s: wg.printData() )
             std::cout << s << '\n';
         std::cout << std::flush;
+        lastStatistics = wg.getStatistics();
 
         return *reinterpret_cast<typeOut*>(parJob->getOutput());
     }
@@ -43,6 +50,22 @@ public:
     std::chrono::duration<double> getDuration(){
         return lastDuration;
     }
+
+    std::string getStatistics(){
+        return lastStatistics;
+    }
+
+    void setLocality(bool nearToData){
+        locality = nearToData;
+    }
+
+    void setOfferCost(uint64_t cost){
+        offerCost = cost;
+    }
+
+    void setShare(int weight){
+        shareWeight = weight;
+    }
 };
 
 template <class typeIn, class typeOut>
@@ -98,6 +121,7 @@ public:
         for( auto &ij: IJ )
             if( !ij->completed() )
                 return false; 
+        return true;
     }
 // if more than one worker is asking for... use atomic counters!
     virtual bool getPendingJob(job*& j) { 
@@ -126,6 +150,14 @@ public:
         return myJobId; 
     }
 
+    virtual std::pair<const void*, const void*> getAffinity() {
+        return dataRange(in);
+    }
+
+    virtual uint64_t estimatedCost() {
+        return jobCost(in);
+    }
+
     virtual ~genericJob() {
     }
 };
@@ -0,0 +1,70 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Cache topology of the machine, read from sysfs: for each cpu */
+/* the cache domain of L2 and L3, named after the smallest cpu  */
+/* sharing that cache; when sysfs is not readable every cpu is  */
+/* alone in its domain. Workers are mapped on the cpus the      */
+/* process may use (sched_getaffinity: taskset, cgroups)        */
+
+struct cacheTopology{
+    std::vector<int> allowed;
+    int n;
+    std::vector<int> L2, L3;
+
+    static cacheTopology& get(){
+        static cacheTopology topology;
+        return topology;
+    }
+
+    int cpu(const int& worker) const {
+        return allowed[worker%allowed.size()];
+    }
+
+    /* 0: same L2, 1: same L3, 2: far away  */
+    int distance(const int& w1, const int& w2) const {
+        if( L2[cpu(w1)]==L2[cpu(w2)] )
+            return 0;
+        if( L3[cpu(w1)]==L3[cpu(w2)] )
+            return 1;
+        return 2;
+    }
+
+    /* pin the calling thread, or the given one, on the cpu of the worker   */
+    bool pin(const int& worker, pthread_t t = pthread_self()) const {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu(worker), &set);
+        return pthread_setaffinity_np(t, sizeof(cpu_set_t), &set)==0;
+    }
+private:
+    cacheTopology() : allowed(allowedCpus()), n(allowed.back()+1), L2(n), L3(n) {
+        for( int c=0; c<n; ++c ){
+            L2[c] = L3[c] = c;
+            for( int index=0; index<8; ++index ){
+                std::string dir("/sys/devices/system/cpu/cpu"+std::to_string(c)+"/cache/index"+std::to_string(index)+'/');
+                std::ifstream levelF(dir+"level"), sharedF(dir+"shared_cpu_list");
+                int level, first;
+                if( !(levelF >> level) || !(sharedF >> first) )
+                    break;
+                if( level==2 )
+                    L2[c] = first;
+                else if( level==3 )
+                    L3[c] = first;
+            }
+        }
+    }
+
+    /* in increasing order; all of them if the set is not readable */
+    static std::vector<int> allowedCpus(){
+        std::vector<int> A;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if( sched_getaffinity(0, sizeof(cpu_set_t), &set)==0 )
+            for( int c=0; c<CPU_SETSIZE; ++c )
+                if( CPU_ISSET(c, &set) )
+                    A.push_back(c);
+        if( A.empty() )
+            for( int c=0; c<static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); ++c )
+                A.push_back(c);
+        return A;
+    }
+};
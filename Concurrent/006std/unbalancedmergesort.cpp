@@ -4,66 +4,197 @@
 /* Notice that alpha and beta MUST be both at least 1   */
 unsigned int alpha{1}, beta{1};
 
-template <typename T>
+/* ratio=auto: the ratio of each parallel divide is chosen from the    */
+/* recent ns per merged element of the workers of the workgroup. With  */
+/* DFS_TO_ME_BFS_TO_YOU the dividing worker keeps the left part and    */
+/* offers the right one, so the left part is the larger one when the   */
+/* worker is faster than the others on average; alpha:beta until both  */
+/* are measured                                                        */
+bool adaptiveRatio{false};
+
+struct workerRate{
+    std::atomic<const void*> group{nullptr};
+    std::atomic<uint64_t> psPerElement{0};      /* moving average over the merges    */
+    std::atomic<bool> counted{false};           /* not a worker of the other tenants */
+};
+
+constexpr int maxRates{256};
+workerRate rates[maxRates];
+std::atomic<int> nRates{0};
+std::atomic<uint32_t> rateGeneration{0};
+constexpr std::ptrdiff_t timedMerge{4096};      /* smaller merges are not timed      */
+
+/* left shares chosen by the last sort, in 1/1024, not by the other tenants */
+std::atomic<uint64_t> adaptiveSplits{0}, shareSum{0};
+std::atomic<uint32_t> shareMin{1024}, shareMax{0};
+
+/* before a sort: the workers of the sort take new slots */
+inline void resetRates(){
+    for( auto &r: rates ){
+        r.group.store(nullptr, std::memory_order_relaxed);
+        r.psPerElement.store(0, std::memory_order_relaxed);
+        r.counted.store(false, std::memory_order_relaxed);
+    }
+    nRates.store(0, std::memory_order_relaxed);
+    rateGeneration.fetch_add(1, std::memory_order_relaxed);
+    adaptiveSplits.store(0, std::memory_order_relaxed);
+    shareSum.store(0, std::memory_order_relaxed);
+    shareMin.store(1024, std::memory_order_relaxed);
+    shareMax.store(0, std::memory_order_relaxed);
+}
+
+/* the slot of the calling worker, nullptr beyond maxRates */
+inline workerRate* myRate(){
+    thread_local uint32_t generation{~0u};
+    thread_local int slot{-1};
+    if( generation!=rateGeneration.load(std::memory_order_relaxed) ){
+        generation = rateGeneration.load(std::memory_order_relaxed);
+        slot = nRates.fetch_add(1, std::memory_order_relaxed);
+        if( slot<maxRates ){
+            rates[slot].group.store(currentWorkgroup, std::memory_order_relaxed);
+            rates[slot].counted.store(!uncounted, std::memory_order_relaxed);
+        }
+    }
+    return slot<maxRates ? &rates[slot] : nullptr;
+}
+
+/* left share of a divide in 1/1024: the others' mean time per element */
+/* over the sum with the worker's one, within [1/8,7/8]; 0 if unknown  */
+inline uint64_t measuredShare(){
+    const workerRate *me(myRate());
+    if( !me )
+        return 0;
+    const uint64_t mine{me->psPerElement.load(std::memory_order_relaxed)};
+    uint64_t others{0}, k{0};
+    for( int s=0; s<std::min(maxRates, nRates.load(std::memory_order_relaxed)); ++s )
+        if( &rates[s]!=me && rates[s].group.load(std::memory_order_relaxed)==me->group.load(std::memory_order_relaxed) ){
+            const uint64_t r{rates[s].psPerElement.load(std::memory_order_relaxed)};
+            others += r;
+            k += r>0;
+        }
+    if( mine==0 || k==0 )
+        return 0;
+    others /= k;
+    return std::min<uint64_t>(896, std::max<uint64_t>(128, 1024*others/(mine+others)));
+}
+
+inline void recordShare(const uint32_t& share){
+    if( uncounted )
+        return;
+    adaptiveSplits.fetch_add(1, std::memory_order_relaxed);
+    shareSum.fetch_add(share, std::memory_order_relaxed);
+    for( uint32_t m{shareMin.load(std::memory_order_relaxed)}; share<m && !shareMin.compare_exchange_weak(m, share, std::memory_order_relaxed); );
+    for( uint32_t m{shareMax.load(std::memory_order_relaxed)}; share>m && !shareMax.compare_exchange_weak(m, share, std::memory_order_relaxed); );
+}
+
+/* the learned shares of the left parts and the ns per merged element */
+/* of the workers, for the statistics reportable                      */
+inline std::string ratioStatistics(){
+    std::string s;
+    const uint64_t d{adaptiveSplits.load(std::memory_order_relaxed)};
+    s += " adaptiveSplits="+std::to_string(d);
+    if( d>0 )
+        s += " leftShare="+std::to_string(shareSum.load(std::memory_order_relaxed)*100/(1024*d))+"%("+std::to_string(shareMin.load(std::memory_order_relaxed)*100/1024)+"%.."+std::to_string(shareMax.load(std::memory_order_relaxed)*100/1024)+"%)";
+    s += " workerNsPerElement=[";
+    bool first{true};
+    for( int r=0; r<std::min(maxRates, nRates.load(std::memory_order_relaxed)); ++r )
+        if( rates[r].counted.load(std::memory_order_relaxed) ){
+            s += (first ? "" : ",")+std::to_string(rates[r].psPerElement.load(std::memory_order_relaxed)/1000.);
+            first = false;
+        }
+    return s+"]";
+}
+
+template <typename T, typename I = sortIndex>
 struct subVector{
     static int threshold;
-    const int depth;
-    subVector(std::vector<T>& V, std::vector<T>& W, const int& i, const int &j) : depth(j-i+1), V(V), W(W), i(i), j(j) {}
-    std::vector<T>& V, &W;
-    int i, j;
+    const I depth;
+    subVector(dataVector<T>& V, dataVector<T>& W, const I& i, const I& j) : depth(j-i+1), V(V), W(W), i(i), j(j) {}
+    dataVector<T>& V, &W;
+    I i, j;
 };
 
-template <>
-int subVector<int>::threshold = 0;
+template <typename T, typename I>
+int subVector<T, I>::threshold = 0;
+
+/* for locality aware placement of jobs */
+template <class T, class I>
+memoryRange dataRange(const subVector<T, I>& V){
+    return memoryRange(V.V.data()+V.i, V.V.data()+V.j+1);
+}
 
-template <class T>
-auto divide = [](const subVector<T>& Vin) -> std::vector<subVector<T>>{
-    std::vector<subVector<T>> Vout;
-    Vout.emplace_back(Vin.V, Vin.W, Vin.i, (alpha*Vin.i+beta*Vin.j)/(alpha+beta));
-    Vout.emplace_back(Vin.V, Vin.W, (alpha*Vin.i+beta*Vin.j)/(alpha+beta)+1, Vin.j);
+template <class T, class I>
+uint64_t jobCost(const subVector<T, I>& V){
+    return sortCost(V.j-V.i+1);
+}
+
+/* the left part ends at (alpha*i+beta*j)/(alpha+beta); only parallel */
+/* divides (above threshold) are adapted                              */
+template <class T, class I>
+auto divide = [](const subVector<T, I>& Vin) -> std::vector<subVector<T, I>>{
+    std::vector<subVector<T, I>> Vout;
+    uint64_t a{alpha}, b{beta};
+    if( adaptiveRatio && Vin.depth>=subVector<T, I>::threshold ){
+        const uint64_t share{measuredShare()};
+        if( share>0 ){
+            recordShare(static_cast<uint32_t>(share));
+            a = 1024-share;
+            b = share;
+        }
+    }
+    const I m{static_cast<I>((a*uint64_t(Vin.i)+b*uint64_t(Vin.j))/(a+b))};
+    Vout.emplace_back(Vin.V, Vin.W, Vin.i, m);
+    Vout.emplace_back(Vin.V, Vin.W, m+1, Vin.j);
     return Vout;
 };
 
-template <class T>
-auto impera = [](const std::vector<subVector<T>>& Vin) -> subVector<T>{
-    subVector<T> Vout(Vin[0].W, Vin[0].V, Vin[0].i, Vin[1].j);
-    int ii[] = { Vin[0].i, Vin[1].i };
-    int i { Vin[0].i };  
-    while( true ){
-        bool b{ Vin[0].V[ii[0]]>Vin[1].V[ii[1]] };
-        bool nb = !b;
-        Vout.V[i++] = Vin[b].V[ii[b]++];
-        if( ii[b] > Vin[b].j ){
-            while( ii[nb] <= Vin[nb].j )
-                Vout.V[i++] = Vin[nb].V[ii[nb]++];
-            break;
-        }
+template <class T, class I>
+auto impera = [](const std::vector<subVector<T, I>>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout(Vin[0].W, Vin[0].V, Vin[0].i, Vin[1].j);
+    auto merge = [&](){
+        mergeRuns(Vin[0].V.data()+Vin[0].i, Vin[0].j-Vin[0].i+1, Vin[1].V.data()+Vin[1].i, Vin[1].j-Vin[1].i+1, Vout.V.data()+Vin[0].i);
+    };
+    const std::ptrdiff_t n{Vin[1].j-Vin[0].i+1};
+    workerRate *me(adaptiveRatio && n>=timedMerge ? myRate() : nullptr);
+    if( !me ){
+        merge();
+        return Vout;
     }
+    const auto begin(std::chrono::steady_clock::now());
+    merge();
+    const uint64_t ps{static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-begin).count())*1000/n}, 
+        old{me->psPerElement.load(std::memory_order_relaxed)};
+    me->psPerElement.store(old==0 ? ps : (7*old+ps)/8, std::memory_order_relaxed);
 
     return Vout;
 };
 
-template <class T>
-auto base = [](const subVector<T>& Vin) -> subVector<T>{
-    subVector<T> Vout{Vin.W, Vin.V, Vin.i, Vin.j};
-    switch(Vin.j-Vin.i){
-    case 1:
-        if( Vin.V[Vin.i]>Vin.V[Vin.j] ){
-            Vout.V[Vin.i]=Vin.V[Vin.j];
-            Vout.V[Vin.j]=Vin.V[Vin.i];
-        } else {
-            Vout.V[Vin.i]=Vin.V[Vin.i];
-            Vout.V[Vin.j]=Vin.V[Vin.j];
-        }
-        break;
-    case 0:
-        Vout.V[Vin.i]=Vin.V[Vin.i];
-        break;
-    } 
+/* blocks up to sortBlock elements, by a sorting network for ints */
+template <class T, class I>
+auto base = [](const subVector<T, I>& Vin) -> subVector<T, I>{
+    subVector<T, I> Vout{Vin.W, Vin.V, Vin.i, Vin.j};
+    sortSmall(Vin.V.data()+Vin.i, Vout.V.data()+Vin.i, Vin.j-Vin.i+1);
+    return Vout;
+};
+
+/* base of a batch of sibling leaves, branchless for pairs   */
+template <class T, class I>
+auto baseBatch = [](const std::vector<subVector<T, I>>& Vin) -> std::vector<subVector<T, I>>{
+    std::vector<subVector<T, I>> Vout;
+    Vout.reserve(Vin.size());
+    for( auto &v: Vin ){
+        Vout.emplace_back(v.W, v.V, v.i, v.j);
+        if( v.j-v.i==1 ){
+            const T a(v.V[v.i]), b(v.V[v.j]);
+            v.W[v.i] = std::min(a, b);
+            v.W[v.j] = std::max(a, b);
+        } else
+            sortSmall(v.V.data()+v.i, v.W.data()+v.i, v.j-v.i+1);
+    }
     return Vout;
 };
 
-template <class T>
-auto isBase = [](const subVector<T>& V) -> bool{
-    return V.j-V.i<2;
+template <class T, class I>
+auto isBase = [](const subVector<T, I>& V) -> bool{
+    return V.j-V.i+1<=std::max(2, sortBlock);
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+/* License : Michele Miccinesi 2018 -                               */
+/* Verification of a sort: the output is in order, checked by       */
+/* chunks in parallel, and a permutation of the input, checked by   */
+/* comparing order independent hashes of the multisets of elements  */
+
+/* chunks of at least 64K elements, at most one per core    */
+inline int coreChunks(const std::size_t& n){
+    return static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), n>>16)));
+}
+
+/* f(c, b, e) for the nC chunks [b,e) of [0,n), each by a thread */
+template <class F>
+void forChunks(const std::size_t& n, const int& nC, const F& f){
+    std::vector<std::thread> C;
+    for( int c=1; c<nC; ++c )
+        C.emplace_back([&f, n, nC, c](){ f(c, n*c/nC, n*(c+1)/nC); });
+    f(0, std::size_t(0), n/nC);
+    for( auto &t: C )
+        t.join();
+}
+
+inline uint64_t mix64(uint64_t x){
+    x = (x^(x>>30))*0xbf58476d1ce4e5b9ull;
+    x = (x^(x>>27))*0x94d049bb133111ebull;
+    return x^(x>>31);
+}
+
+/* Sums of two mixes of the bytes of each element: a sum does not   */
+/* depend on the order and, unlike a xor, is changed by an element  */
+/* repeated twice; different multisets collide with probability     */
+/* about 2^-128                                                     */
+struct multisetHash{
+    uint64_t n{0}, a{0}, b{0};
+
+    template <class T>
+    void add(const T& x){
+        uint64_t k{0};
+        for( std::size_t o=0; o<sizeof(T); o+=8 ){
+            uint64_t w{0};
+            std::memcpy(&w, reinterpret_cast<const char*>(&x)+o, std::min<std::size_t>(8, sizeof(T)-o));
+            k = mix64(k^w);
+        }
+        ++n;
+        a += k;
+        b += mix64(k+0x9e3779b97f4a7c15ull);
+    }
+
+    multisetHash& operator+=(const multisetHash& h){
+        n += h.n;
+        a += h.a;
+        b += h.b;
+        return *this;
+    }
+
+    bool operator==(const multisetHash& h) const {
+        return n==h.n && a==h.a && b==h.b;
+    }
+
+    bool operator!=(const multisetHash& h) const {
+        return !(*this==h);
+    }
+};
+
+template <class T>
+multisetHash hashMultiset(const T* V, const std::size_t& n){
+    const int nC{coreChunks(n)};
+    std::vector<multisetHash> H(nC);
+    forChunks(n, nC, [V, &H](int c, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<e; ++x )
+            H[c].add(V[x]);
+    });
+    for( int c=1; c<nC; ++c )
+        H[0] += H[c];
+    return H[0];
+}
+
+/* The ranks [lo,hi] of V are in place: they are in order, those    */
+/* before are not greater than V[lo] and those after not less than  */
+/* V[hi]; [0,n-1] is a sort, [k,k] a selection, [0,k-1] a partial   */
+/* sort. The least misplaced index, n if none                       */
+template <class T>
+std::size_t firstMisplaced(const T* V, const std::size_t& n, int64_t lo = 0, int64_t hi = std::numeric_limits<int64_t>::max()){
+    lo = std::max<int64_t>(lo, 0);
+    hi = std::min<int64_t>(hi, static_cast<int64_t>(n)-1);
+    if( hi<lo )
+        return n;
+    const std::size_t l(lo), h(hi);
+    const int nC{coreChunks(n)};
+    std::vector<std::size_t> F(nC, n);
+    forChunks(n, nC, [V, l, h, &F](int c, std::size_t b, std::size_t e){
+        for( std::size_t x=b; x<std::min(e, l); ++x )
+            if( V[l]<V[x] ){
+                F[c] = x;
+                return;
+            }
+        for( std::size_t x=std::max(b, l+1); x<std::min(e, h+1); ++x )
+            if( V[x]<V[x-1] ){
+                F[c] = x;
+                return;
+            }
+        for( std::size_t x=std::max(b, h+1); x<e; ++x )
+            if( V[x]<V[h] ){
+                F[c] = x;
+                return;
+            }
+    });
+    return *std::min_element(F.begin(), F.end());
+}
@@ -0,0 +1,112 @@
+/* License : Michele Miccinesi 2018 -                           */
+/* Process wide pool of running workers: workgroups joining it  */
+/* (tenants) keep their own threads, but only as many of them   */
+/* as the pool allows are running, the others are parked.       */
+/* The share of a tenant is capacity*weight/sum of weights (at  */
+/* least 1, its caller); a tenant may run more than its share   */
+/* while cores are free, and is asked to give them back as soon */
+/* as another tenant below its share is waiting                 */
+
+class workerPool{
+public:
+    struct tenant{
+        int weight{1}, running{0}, parked{0};
+        std::atomic<bool> over{false};          /* running beyond its share, read relaxed   */
+    };
+private:
+    int capacity;                               /* running workers, one per core    */
+    std::mutex m;
+    std::condition_variable cv;
+    std::vector<tenant*> T;
+    int running{0}, weights{0};
+
+    explicit workerPool(int capacity) : capacity(capacity) {}
+
+    int share(const tenant& t) const {
+        return std::max(1, capacity*t.weight/std::max(1, weights));
+    }
+
+    bool starved(const tenant* const but) const {
+        for( auto &t: T )
+            if( t!=but && t->parked>0 && t->running<share(*t) )
+                return true;
+        return false;
+    }
+
+    bool mayRun(const tenant& t) const {
+        return running<capacity && (t.running<share(t) || !starved(&t));
+    }
+
+    void rebalance(){
+        for( auto &t: T )
+            t->over.store(t->running>share(*t) && (running>capacity || starved(t)), std::memory_order_relaxed);
+        cv.notify_all();
+    }
+public:
+    static workerPool& get(){
+        static workerPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    workerPool(const workerPool&) = delete;
+    workerPool& operator=(const workerPool&) = delete;
+
+    void resize(const int& n){
+        std::lock_guard<std::mutex> lock(m);
+        capacity = std::max(1, n);
+        rebalance();
+    }
+
+    /* the caller is running, the other workers are parked */
+    void join(tenant& t, const int& workers){
+        std::lock_guard<std::mutex> lock(m);
+        t.running = 1;
+        t.parked = workers-1;
+        ++running;
+        weights += t.weight;
+        T.push_back(&t);
+        rebalance();
+    }
+
+    void leave(tenant& t){
+        std::lock_guard<std::mutex> lock(m);
+        running -= t.running;
+        weights -= t.weight;
+        t.running = t.parked = 0;
+        T.erase(std::find(T.begin(), T.end(), &t));
+        rebalance();
+    }
+
+    void park(tenant& t){
+        std::lock_guard<std::mutex> lock(m);
+        --t.running;
+        ++t.parked;
+        --running;
+        rebalance();
+    }
+
+    /* false if stop() became true before the pool let us run   */
+    template <class F>
+    bool unpark(tenant& t, F stop){
+        std::unique_lock<std::mutex> lock(m);
+        while( !mayRun(t) ){
+            if( stop() ){
+                --t.parked;
+                return false;
+            }
+            cv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        --t.parked;
+        ++t.running;
+        ++running;
+        rebalance();
+        return true;
+    }
+
+    void release(tenant& t){
+        std::lock_guard<std::mutex> lock(m);
+        --t.running;
+        --running;
+        rebalance();
+    }
+};